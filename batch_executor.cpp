@@ -0,0 +1,209 @@
+#include "batch_executor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include "tasks.h"
+
+using namespace std;
+
+namespace {
+    using Clock = chrono::steady_clock;
+
+    uint64_t elapsedNs(Clock::time_point from, Clock::time_point to) {
+        return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(to - from).count());
+    }
+
+    string trim(const string& text) {
+        size_t first = text.find_first_not_of(" \t\r");
+        if (first == string::npos) {
+            return "";
+        }
+        size_t last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+
+    string pathOr(const string& path, const char* defaultPath) {
+        return path.empty() ? string(defaultPath) : path;
+    }
+
+    /**
+     * @brief Returns the size of a file, or 0 if it does not exist.
+     */
+    uint64_t fileSize(const string& path) {
+        error_code error;
+        uintmax_t size = filesystem::file_size(path, error);
+        return error ? 0 : static_cast<uint64_t>(size);
+    }
+
+    /**
+     * @brief Runs one job on the calling thread with its own task streams.
+     */
+    JobResult executeJob(const BatchJob& job, Clock::time_point submitted) {
+        JobResult result;
+        result.job = job;
+
+        string answers = job.answers;
+        replace(answers.begin(), answers.end(), ';', '\n');
+        istringstream input(answers + "\n");
+        ostream console(nullptr);  // Prompts and console echo are dropped
+        ostringstream errors;
+
+        auto start = Clock::now();
+        result.queuedNs = elapsedNs(submitted, start);
+        {
+            TaskIoScope io(input, console, errors);
+            try {
+                runJob(job);
+            }
+            catch (const exception& e) {
+                errors << e.what() << "\n";
+            }
+        }
+        result.latencyNs = elapsedNs(start, Clock::now());
+
+        result.errors = errors.str();
+        switch (job.task) {
+        case 1: result.bytesOut = fileSize(pathOr(job.outputPath, TASK1_OUTPUT)); break;
+        case 2: result.bytesOut = fileSize(pathOr(job.outputPath, TASK2_OUTPUT)); break;
+        case 3: result.bytesOut = fileSize(pathOr(job.outputPath, TASK3_OUTPUT)); break;
+        case 4: result.bytesOut = fileSize(pathOr(job.outputPath, TASK4_OUTPUT)); break;
+        case 5:
+            result.bytesOut = fileSize(pathOr(job.outputPath, TASK5_OUTPUT))
+                + fileSize(pathOr(job.fibonacciOutputPath, TASK5_FIBONACCI_OUTPUT));
+            break;
+        case 6: result.bytesOut = fileSize(pathOr(job.outputPath, TASK6_OUTPUT)); break;
+        }
+        return result;
+    }
+}
+
+void runJob(const BatchJob& job) {
+    switch (job.task) {
+    case 1:
+        task1(pathOr(job.outputPath, TASK1_OUTPUT));
+        break;
+    case 2:
+        task2(pathOr(job.inputPath, TASK2_INPUT), pathOr(job.outputPath, TASK2_OUTPUT), job.printTerms);
+        break;
+    case 3:
+        task3(pathOr(job.inputPath, TASK3_INPUT), pathOr(job.outputPath, TASK3_OUTPUT), job.printProduct);
+        break;
+    case 4:
+        task4(pathOr(job.inputPath, TASK4_INPUT), pathOr(job.outputPath, TASK4_OUTPUT));
+        break;
+    case 5:
+        task5(pathOr(job.inputPath, TASK5_INPUT), pathOr(job.outputPath, TASK5_OUTPUT),
+            pathOr(job.fibonacciOutputPath, TASK5_FIBONACCI_OUTPUT));
+        break;
+    case 6:
+        task6(pathOr(job.inputPath, TASK6_DATABASE), pathOr(job.outputPath, TASK6_OUTPUT));
+        break;
+    default:
+        throw invalid_argument("Invalid task ID: " + to_string(job.task) + " (expected 1-6)");
+    }
+}
+
+vector<BatchJob> readJobList(const string& filepath) {
+    ifstream file(filepath);
+    if (!file.is_open()) {
+        throw runtime_error("Cannot open job list: " + filepath);
+    }
+
+    vector<BatchJob> jobs;
+    string line;
+    int lineNumber = 0;
+    while (getline(file, line)) {
+        ++lineNumber;
+        string text = trim(line);
+        if (text.empty() || text[0] == '#') {
+            continue;
+        }
+
+        vector<string> fields;
+        istringstream in(text);
+        string field;
+        while (getline(in, field, '|')) {
+            fields.push_back(trim(field));
+        }
+        fields.resize(max<size_t>(fields.size(), 5));
+
+        BatchJob job;
+        job.task = atoi(fields[0].c_str());
+        if (job.task < 1 || job.task > 6) {
+            throw runtime_error("Invalid task ID in " + filepath + ", line " + to_string(lineNumber)
+                + ": " + fields[0]);
+        }
+        job.inputPath = fields[1];
+        job.outputPath = fields[2];
+        job.fibonacciOutputPath = fields[3];
+        job.answers = fields[4];
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+BatchReport runBatch(const vector<BatchJob>& jobs, ThreadPool& pool) {
+    BatchReport report;
+    report.threads = pool.size();
+
+    auto start = Clock::now();
+    vector<future<JobResult>> pending;
+    pending.reserve(jobs.size());
+    for (const auto& job : jobs) {
+        pending.push_back(pool.submit([job, start]() { return executeJob(job, start); }));
+    }
+
+    for (auto& result : pending) {
+        report.jobs.push_back(result.get());
+    }
+    report.wallNs = elapsedNs(start, Clock::now());
+    return report;
+}
+
+void printBatchReport(const BatchReport& report, ostream& out) {
+    out << "========== BATCH REPORT ==========\n";
+    out << setw(4) << "Job" << " | " << setw(4) << "Task" << " | "
+        << setw(11) << "Queued (ms)" << " | " << setw(12) << "Latency (ms)" << " | "
+        << setw(10) << "Bytes out" << " | Status\n";
+    out << string(70, '-') << "\n";
+
+    vector<uint64_t> latencies;
+    uint64_t totalBytes = 0;
+    size_t failed = 0;
+    out << fixed << setprecision(3);
+    for (size_t i = 0; i < report.jobs.size(); ++i) {
+        const JobResult& result = report.jobs[i];
+        latencies.push_back(result.latencyNs);
+        totalBytes += result.bytesOut;
+
+        string status = "ok";
+        if (!result.errors.empty()) {
+            ++failed;
+            status = result.errors.substr(0, result.errors.find('\n'));
+        }
+
+        out << setw(4) << (i + 1) << " | " << setw(4) << result.job.task << " | "
+            << setw(11) << result.queuedNs / 1e6 << " | " << setw(12) << result.latencyNs / 1e6 << " | "
+            << setw(10) << result.bytesOut << " | " << status << "\n";
+    }
+    out << string(70, '=') << "\n";
+
+    const double wallSeconds = report.wallNs / 1e9;
+    out << "Jobs: " << report.jobs.size() << " (" << failed << " with errors), threads: "
+        << report.threads << ", wall time: " << report.wallNs / 1e6 << " ms\n";
+    if (!latencies.empty() && wallSeconds > 0) {
+        sort(latencies.begin(), latencies.end());
+        out << "Throughput: " << report.jobs.size() / wallSeconds << " jobs/s, "
+            << totalBytes / wallSeconds / (1024 * 1024) << " MiB/s written\n";
+        out << "Latency: median " << latencies[latencies.size() / 2] / 1e6
+            << " ms, max " << latencies.back() / 1e6 << " ms\n";
+    }
+}
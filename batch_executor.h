@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "thread_pool.h"
+
+/**
+ * @brief One task run of a batch: task number, its files and prompt answers.
+ * Empty paths mean "use the task's default file".
+ */
+struct BatchJob {
+    int task = 0;
+    std::string inputPath;
+    std::string outputPath;
+    std::string fibonacciOutputPath;    ///< Second output of task 5
+    std::string answers;                ///< Prompt answers; ';' separates lines
+    bool printTerms = true;             ///< Task 2: false writes only the statistics
+    bool printProduct = false;          ///< Task 3: also write the product A x B^T
+};
+
+/**
+ * @brief Outcome and timing of one job.
+ */
+struct JobResult {
+    BatchJob job;
+    std::uint64_t queuedNs = 0;     ///< Time between submission and start
+    std::uint64_t latencyNs = 0;    ///< Run time of the job itself
+    std::uint64_t bytesOut = 0;     ///< Size of the job's output files afterwards
+    std::string errors;             ///< Everything the task printed to its error stream
+};
+
+/**
+ * @brief Results of a whole batch, in job-list order.
+ */
+struct BatchReport {
+    std::vector<JobResult> jobs;
+    std::uint64_t wallNs = 0;
+    std::size_t threads = 0;
+};
+
+/**
+ * @brief Runs the job's task on the calling thread with the job's paths.
+ * @throws invalid_argument if the task number is not 1-6
+ */
+void runJob(const BatchJob& job);
+
+/**
+ * @brief Reads a job list.
+ * One job per line, fields separated by '|':
+ * task | input | output | fibonacci output | answers
+ * Trailing fields may be omitted, empty fields mean the default; blank lines
+ * and lines starting with '#' are skipped.
+ * @param filepath Path to the job list
+ * @return Jobs in file order
+ * @throws runtime_error if the file cannot be opened or a line is invalid
+ */
+std::vector<BatchJob> readJobList(const std::string& filepath);
+
+/**
+ * @brief Runs every job on the pool and waits for all of them.
+ * Each job gets its own prompt answers, a discarded console and a captured
+ * error stream (see TaskIoScope), and writes only its own output files.
+ * Jobs must not share output files (the task 6 database included).
+ * @param jobs Jobs to run
+ * @param pool Pool to run them on
+ * @return Per-job results and the wall time of the batch
+ */
+BatchReport runBatch(const std::vector<BatchJob>& jobs, ThreadPool& pool);
+
+/**
+ * @brief Prints per-job latency and aggregate throughput of a batch.
+ */
+void printBatchReport(const BatchReport& report, std::ostream& out);
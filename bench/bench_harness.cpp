@@ -0,0 +1,92 @@
+#include "bench_harness.h"
+
+#include <random>
+
+using namespace std;
+
+namespace {
+    /**
+     * @brief Writes a string as a JSON literal (names here never need more than quote escaping).
+     */
+    void writeJsonString(ostream& out, const string& text) {
+        out << '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') out << '\\';
+            out << c;
+        }
+        out << '"';
+    }
+
+    /**
+     * @brief Orders generated values according to the distribution name.
+     */
+    template<typename T>
+    void arrange(vector<T>& data, const string& distribution) {
+        if (distribution == "sorted") {
+            sort(data.begin(), data.end());
+        }
+        else if (distribution == "reversed") {
+            sort(data.rbegin(), data.rend());
+        }
+    }
+}
+
+void BenchRunner::writeJson(ostream& out) const {
+    out.precision(6);
+    out << "{\n  \"config\": {\"distribution\": ";
+    writeJsonString(out, config_.distribution);
+    out << ", \"warmup\": " << config_.warmup
+        << ", \"repetitions\": " << config_.repetitions
+        << ", \"min_sample_ms\": " << config_.minSampleMs
+        << ", \"seed\": " << config_.seed << ", \"sizes\": [";
+    for (size_t i = 0; i < config_.sizes.size(); ++i) {
+        out << (i ? ", " : "") << config_.sizes[i];
+    }
+    out << "]},\n  \"results\": [";
+
+    for (size_t i = 0; i < results_.size(); ++i) {
+        const BenchResult& r = results_[i];
+        out << (i ? ",\n" : "\n") << "    {\"name\": ";
+        writeJsonString(out, r.name);
+        out << ", \"size\": " << r.size
+            << ", \"iterations_per_sample\": " << r.iterationsPerSample
+            << ", \"median_ns\": " << r.medianNs
+            << ", \"p99_ns\": " << r.p99Ns
+            << ", \"min_ns\": " << r.minNs
+            << ", \"items_per_second\": " << r.itemsPerSecond
+            << ", \"bytes_per_second\": " << r.bytesPerSecond << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+vector<int> makeIntData(size_t n, const string& distribution, uint64_t seed) {
+    mt19937_64 rng(seed);
+    const int upper = (distribution == "few-unique") ? 15 : static_cast<int>(min<size_t>(n, 1000000));
+    uniform_int_distribution<int> values(0, max(upper, 1));
+
+    vector<int> data(n);
+    for (auto& value : data) {
+        value = values(rng);
+    }
+    arrange(data, distribution);
+    return data;
+}
+
+vector<double> makeDoubleData(size_t n, const string& distribution, uint64_t seed) {
+    mt19937_64 rng(seed);
+    vector<double> data(n);
+    if (distribution == "few-unique") {
+        uniform_int_distribution<int> values(-8, 8);  // Includes zeros for the division paths
+        for (auto& value : data) {
+            value = values(rng) * 0.5;
+        }
+    }
+    else {
+        uniform_real_distribution<double> values(-1000.0, 1000.0);
+        for (auto& value : data) {
+            value = values(rng);
+        }
+    }
+    arrange(data, distribution);
+    return data;
+}
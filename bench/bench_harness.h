@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Benchmark settings taken from the command line.
+ */
+struct BenchConfig {
+    std::vector<std::size_t> sizes{ 1000, 100000 };    ///< Problem sizes for size-dependent kernels
+    std::string distribution = "uniform";              ///< uniform, sorted, reversed or few-unique
+    int warmup = 3;                                    ///< Untimed samples before measuring
+    int repetitions = 25;                              ///< Timed samples per benchmark
+    double minSampleMs = 2.0;                          ///< Calibrated minimum duration of one sample
+    std::size_t selectionSortLimit = 20000;            ///< Largest size given to O(n^2) kernels
+    std::string filter;                                ///< Run only benchmarks whose name contains this
+    std::uint64_t seed = 42;                           ///< Seed for generated data
+};
+
+/**
+ * @brief Timing summary of one benchmark at one size.
+ */
+struct BenchResult {
+    std::string name;
+    std::size_t size = 0;
+    std::size_t iterationsPerSample = 0;
+    double medianNs = 0.0;          ///< Median time of one call
+    double p99Ns = 0.0;             ///< 99th percentile time of one call
+    double minNs = 0.0;
+    double itemsPerSecond = 0.0;    ///< Items processed per second at the median
+    double bytesPerSecond = 0.0;    ///< Bytes touched per second at the median
+};
+
+/// Destination of doNotOptimize(); volatile so the store cannot be dropped
+inline volatile char g_benchSink;
+
+/**
+ * @brief Prevents the compiler from discarding a computed value.
+ */
+template<typename T>
+inline void doNotOptimize(const T& value) {
+    g_benchSink = *reinterpret_cast<const volatile char*>(&value);
+}
+
+/**
+ * @brief Runs and records benchmarks: calibration, warmup, repetitions, statistics.
+ */
+class BenchRunner {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    BenchConfig config_;
+    std::vector<BenchResult> results_;
+
+    template<typename Body>
+    static double timeSample(Body& body, std::size_t iterations) {
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            body();
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+public:
+    explicit BenchRunner(const BenchConfig& config) : config_(config) {}
+
+    const BenchConfig& config() const {
+        return config_;
+    }
+
+    const std::vector<BenchResult>& results() const {
+        return results_;
+    }
+
+    /**
+     * @brief Returns true if the benchmark passes the --filter setting.
+     */
+    bool enabled(std::string_view name) const {
+        return config_.filter.empty() || name.find(config_.filter) != std::string_view::npos;
+    }
+
+    /**
+     * @brief Measures one benchmark.
+     * The body is called often enough that a sample lasts at least minSampleMs,
+     * so very small kernels are not dominated by clock overhead.
+     * @param name Benchmark name ("task/kernel[/variant]")
+     * @param size Problem size reported with the result
+     * @param items Items processed by one call of body
+     * @param bytes Bytes read and written by one call of body
+     * @param body Callable invoked once per iteration
+     */
+    template<typename Body>
+    void run(const std::string& name, std::size_t size, std::size_t items, std::size_t bytes, Body&& body) {
+        if (!enabled(name)) {
+            return;
+        }
+
+        // Calibrate iterations per sample
+        std::size_t iterations = 1;
+        const double minSampleNs = config_.minSampleMs * 1e6;
+        while (iterations < (std::size_t(1) << 30) && timeSample(body, iterations) < minSampleNs) {
+            iterations *= 2;
+        }
+
+        for (int i = 0; i < config_.warmup; ++i) {
+            timeSample(body, iterations);
+        }
+
+        std::vector<double> samples;
+        samples.reserve(static_cast<std::size_t>(config_.repetitions));
+        for (int i = 0; i < config_.repetitions; ++i) {
+            samples.push_back(timeSample(body, iterations) / static_cast<double>(iterations));
+        }
+        std::sort(samples.begin(), samples.end());
+
+        BenchResult result;
+        result.name = name;
+        result.size = size;
+        result.iterationsPerSample = iterations;
+        result.minNs = samples.front();
+        result.medianNs = samples[samples.size() / 2];
+        std::size_t p99Index = (samples.size() * 99 + 99) / 100;  // Nearest rank
+        result.p99Ns = samples[std::min(samples.size(), std::max<std::size_t>(p99Index, 1)) - 1];
+        result.itemsPerSecond = static_cast<double>(items) * 1e9 / result.medianNs;
+        result.bytesPerSecond = static_cast<double>(bytes) * 1e9 / result.medianNs;
+        results_.push_back(result);
+
+        std::cerr << name << " [" << size << "]: median " << result.medianNs << " ns, p99 "
+            << result.p99Ns << " ns\n";
+    }
+
+    /**
+     * @brief Writes configuration and all results as a JSON document.
+     */
+    void writeJson(std::ostream& out) const;
+};
+
+// Data generators (bench_harness.cpp)
+std::vector<int> makeIntData(std::size_t n, const std::string& distribution, std::uint64_t seed);
+std::vector<double> makeDoubleData(std::size_t n, const std::string& distribution, std::uint64_t seed);
+
+// Benchmark suites, one per task source file
+void runTask2Benchmarks(BenchRunner& runner);
+void runTask3Benchmarks(BenchRunner& runner);
+void runTask4Benchmarks(BenchRunner& runner);
+void runTask5Benchmarks(BenchRunner& runner);
+void runTask6Benchmarks(BenchRunner& runner);
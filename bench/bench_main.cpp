@@ -0,0 +1,121 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "bench_harness.h"
+#include "output_sink.h"
+
+using namespace std;
+
+/**
+ * @brief Prints command-line usage of the benchmark executable.
+ */
+void printUsage(ostream& out) {
+    out << "Usage: bench [options]\n"
+        << "  --sizes N,N,...          Problem sizes (default: 1000,100000)\n"
+        << "  --distribution NAME      uniform, sorted, reversed or few-unique\n"
+        << "  --warmup N               Untimed samples per benchmark (default: 3)\n"
+        << "  --reps N                 Timed samples per benchmark (default: 25)\n"
+        << "  --min-sample-ms X        Minimum duration of one sample (default: 2)\n"
+        << "  --selection-sort-limit N Largest size for selectionSort (default: 20000)\n"
+        << "  --filter TEXT            Run only benchmarks whose name contains TEXT\n"
+        << "  --seed N                 Seed for generated data (default: 42)\n"
+        << "  --json PATH              Write results to PATH instead of stdout\n";
+}
+
+/**
+ * @brief Parses a comma-separated list of sizes.
+ * @return false if the list is empty or contains a non-number
+ */
+bool parseSizes(const string& text, vector<size_t>& sizes) {
+    sizes.clear();
+    istringstream in(text);
+    string item;
+    while (getline(in, item, ',')) {
+        char* end = nullptr;
+        unsigned long long value = strtoull(item.c_str(), &end, 10);
+        if (item.empty() || *end != '\0') {
+            return false;
+        }
+        sizes.push_back(static_cast<size_t>(value));
+    }
+    return !sizes.empty();
+}
+
+/**
+ * @brief Runs every benchmark suite and writes the results as JSON.
+ * Task output is discarded so terminal and disk do not distort the timings.
+ *
+ * @return int Exit code (0 for success)
+ */
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+    string jsonPath;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--help") {
+            printUsage(cout);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            cerr << "Missing value for option: " << arg << "\n";
+            return 1;
+        }
+        string value = argv[++i];
+
+        if (arg == "--sizes") {
+            if (!parseSizes(value, config.sizes)) {
+                cerr << "Invalid size list: " << value << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--distribution") {
+            if (value != "uniform" && value != "sorted" && value != "reversed" && value != "few-unique") {
+                cerr << "Invalid distribution: " << value << "\n";
+                return 1;
+            }
+            config.distribution = value;
+        }
+        else if (arg == "--warmup") config.warmup = atoi(value.c_str());
+        else if (arg == "--reps") config.repetitions = max(1, atoi(value.c_str()));
+        else if (arg == "--min-sample-ms") config.minSampleMs = atof(value.c_str());
+        else if (arg == "--selection-sort-limit") config.selectionSortLimit = strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--filter") config.filter = value;
+        else if (arg == "--seed") config.seed = strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--json") jsonPath = value;
+        else {
+            cerr << "Unknown option: " << arg << "\n";
+            printUsage(cerr);
+            return 1;
+        }
+    }
+
+    // Kernels that print go nowhere while being measured
+    setOutputMode(OutputMode::DISCARD);
+    streambuf* console = cout.rdbuf(nullptr);
+
+    BenchRunner runner(config);
+    runTask2Benchmarks(runner);
+    runTask3Benchmarks(runner);
+    runTask4Benchmarks(runner);
+    runTask5Benchmarks(runner);
+    runTask6Benchmarks(runner);
+
+    cout.rdbuf(console);
+
+    if (jsonPath.empty()) {
+        runner.writeJson(cout);
+    }
+    else {
+        ofstream json(jsonPath);
+        if (!json.is_open()) {
+            cerr << "Cannot open output file: " << jsonPath << "\n";
+            return 1;
+        }
+        runner.writeJson(json);
+    }
+    return 0;
+}
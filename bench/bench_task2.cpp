@@ -0,0 +1,88 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench_harness.h"
+#include "cpu_features.h"
+#include "pairwise_sum.h"
+#include "sequence_generator.h"
+#include "sequence_kernels.h"
+#include "task2.h"
+
+using namespace std;
+
+/**
+ * @brief Benchmarks term generation of task 2 for each size.
+ * Compares the former per-term loop (compute one term, stream it) with the
+ * block path (SIMD fill, bulk format), the coroutine generator and the fill
+ * kernel alone per SIMD level.
+ * Also compares the running-sum loop with the pairwise sum per SIMD level and
+ * on the pool over generated terms.
+ */
+void runTask2Benchmarks(BenchRunner& runner) {
+    const BenchConfig& config = runner.config();
+    const double a0 = 3.25;
+    const double d = 0.75;
+
+    vector<unique_ptr<OutputSink>> sinks;
+    sinks.push_back(make_unique<NullSink>());
+    DualOutputWriter output(move(sinks));
+
+    vector<SimdLevel> levels;
+    for (SimdLevel level : { SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+        if (level <= detectedSimdLevel()) {
+            levels.push_back(level);
+        }
+    }
+
+    for (size_t n : config.sizes) {
+        const long long count = static_cast<long long>(n);
+
+        runner.run("task2/terms/per_term", n, n, n * sizeof(double), [&] {
+            for (long long i = 1; i <= count; ++i) {
+                output << generalField(a0 + (i - 1) * d) << " ";
+            }
+        });
+
+        runner.run("task2/terms/block", n, n, n * sizeof(double), [&] {
+            for (long long i = 1; i <= count; i += TERM_BLOCK) {
+                writeTermBlock(a0, d, i, min(TERM_BLOCK, count - i + 1), output);
+            }
+        });
+
+        runner.run("task2/terms/generator", n, n, n * sizeof(double), [&] {
+            writeTerms(take(arithmeticSequence(a0, d), count), output);
+        });
+
+        vector<double> terms(n);
+        for (SimdLevel level : levels) {
+            setSimdLevel(level);
+            runner.run(string("task2/fill/") + simdLevelName(level), n, n, n * sizeof(double), [&] {
+                fillSequenceTerms(a0, d, 1, n, terms.data());
+                doNotOptimize(terms.back());
+            });
+        }
+
+        runner.run("task2/sum/naive", n, n, n * sizeof(double), [&] {
+            double sum = 0.0;
+            for (double term : terms) {
+                sum += term;
+            }
+            doNotOptimize(sum);
+        });
+
+        for (SimdLevel level : levels) {
+            setSimdLevel(level);
+            runner.run(string("task2/sum/pairwise/") + simdLevelName(level), n, n, n * sizeof(double), [&] {
+                doNotOptimize(pairwiseSum(terms.data(), terms.size()));
+            });
+        }
+        setSimdLevel(SimdLevel::AVX512);
+
+        runner.run("task2/sum/pairwise_generated", n, n, 0, [&] {
+            doNotOptimize(pairwiseSum(sharedThreadPool(), count, [&](long long first, size_t size, double* out) {
+                fillSequenceTerms(a0, d, first + 1, size, out);
+            }));
+        });
+    }
+}
@@ -0,0 +1,232 @@
+#include <charconv>
+#include <cmath>
+#include <functional>
+
+#include "bench_harness.h"
+#include "cpu_features.h"
+#include "matrix_expression.h"
+#include "matrix_multiply.h"
+#include "matrix_text.h"
+#include "matrix_transpose.h"
+#include "task3.h"
+
+using namespace std;
+
+namespace {
+    /**
+     * @brief Fills a rows x cols task 3 matrix from generated data.
+     */
+    Matrix makeMatrix(const BenchConfig& config, size_t rows, size_t cols, uint64_t seed) {
+        vector<double> data = makeDoubleData(rows * cols, config.distribution, seed);
+        Matrix matrix(rows, cols);
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                matrix[i][j] = data[i * cols + j];
+            }
+        }
+        return matrix;
+    }
+
+    /**
+     * @brief Writes matrices as task 3 input text, one row per line.
+     */
+    string matrixText(const vector<const Matrix*>& matrices) {
+        string text;
+        char buffer[32];
+        for (const Matrix* matrix : matrices) {
+            for (size_t i = 0; i < matrix->rows(); ++i) {
+                for (size_t j = 0; j < matrix->cols(); ++j) {
+                    text.append(buffer, to_chars(buffer, buffer + sizeof(buffer), (*matrix)[i][j]).ptr);
+                    text += ' ';
+                }
+                text += '\n';
+            }
+        }
+        return text;
+    }
+}
+
+/**
+ * @brief Benchmarks the task 3 kernels on square matrices.
+ * Each configured size n is rounded to a side of floor(sqrt(n)) elements.
+ */
+void runTask3Benchmarks(BenchRunner& runner) {
+    const BenchConfig& config = runner.config();
+
+    vector<SimdLevel> levels;
+    for (SimdLevel level : { SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+        if (level <= detectedSimdLevel()) {
+            levels.push_back(level);
+        }
+    }
+
+    for (size_t n : config.sizes) {
+        const size_t side = max<size_t>(1, static_cast<size_t>(sqrt(static_cast<double>(n))));
+        const Matrix a = makeMatrix(config, side, side, config.seed);
+        const Matrix b = makeMatrix(config, side, side, config.seed + 1);
+        Matrix result(side, side);
+
+        const size_t elements = side * side;
+        const size_t bytes = 3 * elements * sizeof(double);
+
+        // Each operation through its inlined kernel and through a std::function (the former interface)
+        auto benchOperation = [&](const string& name, auto op) {
+            runner.run("task3/applyElementWiseOperation/" + name, elements, elements, bytes, [&] {
+                applyElementWiseOperation(a, b, result, op, name);
+                doNotOptimize(result[0][0]);
+            });
+
+            const function<double(double, double)> wrapped = op;
+            runner.run("task3/applyElementWiseOperation/" + name + "/std_function", elements, elements, bytes, [&] {
+                applyElementWiseOperation(a, b, result, wrapped, name);
+                doNotOptimize(result[0][0]);
+            });
+        };
+        benchOperation("add", AddOp());
+        benchOperation("subtract", SubtractOp());
+        benchOperation("multiply", MultiplyOp());
+        benchOperation("safe_divide", SafeDivideOp());
+
+        runner.run("task3/maxElementWise", elements, elements, bytes, [&] {
+            maxElementWise(a, b, result);
+            doNotOptimize(result[0][0]);
+        });
+
+        // The dispatched row kernels at each instruction set; scalar is the portable loop
+        for (SimdLevel level : levels) {
+            setSimdLevel(level);
+            runner.run(string("task3/safe_divide/") + simdLevelName(level), elements, elements, bytes, [&] {
+                transformElements(a, b, result, SafeDivideOp());
+                doNotOptimize(result[0][0]);
+            });
+            runner.run(string("task3/max/") + simdLevelName(level), elements, elements, bytes, [&] {
+                transformElements(a, b, result, MaxOp());
+                doNotOptimize(result[0][0]);
+            });
+        }
+        setSimdLevel(SimdLevel::AVX512);
+
+        // max(a, b) - a * b as three kernel passes with temporaries, then as one fused expression
+        Matrix maxima(side, side), products(side, side);
+        runner.run("task3/expression/separate", elements, elements, 7 * elements * sizeof(double), [&] {
+            maxElementWise(a, b, maxima);
+            applyElementWiseOperation(a, b, products, MultiplyOp(), "multiplication");
+            applyElementWiseOperation(maxima, products, result, SubtractOp(), "subtraction");
+            doNotOptimize(result[0][0]);
+        });
+
+        runner.run("task3/expression/fused", elements, elements, bytes, [&] {
+            evaluateInto(result, elementMax(a, b) - a * b);
+            doNotOptimize(result[0][0]);
+        });
+
+        // A new, uninitialized result per call, first touched by the bands computing it
+        runner.run("task3/expression/evaluate", elements, elements, bytes, [&] {
+            const Matrix fresh = evaluate(elementMax(a, b) - a * b);
+            doNotOptimize(fresh[0][0]);
+        });
+
+        runner.run("task3/elementRange", elements, elements, elements * sizeof(double), [&] {
+            const ElementRange range = elementRange(a);
+            doNotOptimize(range.max);
+        });
+
+        // Both matrices as input text: token by token, then one row per line in bands
+        const string text = matrixText({ &a, &b });
+        Matrix parsedA(side, side), parsedB(side, side);
+        runner.run("task3/readMatrix/sequential", 2 * elements, 2 * elements, text.size(), [&] {
+            TextScanner input(text);
+            readMatrix(input, parsedA);
+            readMatrix(input, parsedB);
+            doNotOptimize(parsedB[0][0]);
+        });
+
+        runner.run("task3/readMatrix/rows", 2 * elements, 2 * elements, text.size(), [&] {
+            parseMatrixRows(text, { parsedA, parsedB });
+            doNotOptimize(parsedB[0][0]);
+        });
+
+        runner.run("task3/readMatrix/parallel", 2 * elements, 2 * elements, text.size(), [&] {
+            parseMatrixRows(sharedThreadPool(), text, { parsedA, parsedB });
+            doNotOptimize(parsedB[0][0]);
+        });
+
+        // Element by element in source order, the loop transposeMatrix used to run
+        Matrix transposed(side, side);
+        runner.run("task3/transpose/naive", elements, elements, 2 * elements * sizeof(double), [&] {
+            for (size_t i = 0; i < side; ++i) {
+                for (size_t j = 0; j < side; ++j) {
+                    transposed[j][i] = a[i][j];
+                }
+            }
+            doNotOptimize(transposed[0][0]);
+        });
+
+        runner.run("task3/transposeMatrix", elements, elements, 2 * elements * sizeof(double), [&] {
+            transposeMatrix(a, transposed);
+            doNotOptimize(transposed[0][0]);
+        });
+
+        runner.run("task3/transpose/parallel", elements, elements, 2 * elements * sizeof(double), [&] {
+            transposeInto(sharedThreadPool(), a, transposed);
+            doNotOptimize(transposed[0][0]);
+        });
+
+        Matrix square = a;
+        runner.run("task3/transpose/in_place_square", elements, elements, 2 * elements * sizeof(double), [&] {
+            transposeInPlace(square);
+            doNotOptimize(square[0][0]);
+        });
+
+        // side/2 x 2*side, rounded to whole row quanta so both orientations fit the storage
+        const size_t shortSide = max(MATRIX_ROW_QUANTUM, side / 2 / MATRIX_ROW_QUANTUM * MATRIX_ROW_QUANTUM);
+        Matrix wide = makeMatrix(config, shortSide, 4 * shortSide, config.seed);
+        const size_t wideElements = 4 * shortSide * shortSide;
+        runner.run("task3/transpose/in_place_rectangular", wideElements, wideElements,
+            2 * wideElements * sizeof(double), [&] {
+            transposeInPlace(wide);
+            doNotOptimize(wide[0][0]);
+        });
+
+        // Products of side x side matrices; items are floating-point operations, so
+        // items_per_second is FLOP/s. The naive loop is the i-j-k dot product form.
+        const size_t flops = 2 * side * side * side;
+        Matrix product(side, side);
+        runner.run("task3/multiply/naive", elements, flops, bytes, [&] {
+            for (size_t i = 0; i < side; ++i) {
+                for (size_t j = 0; j < side; ++j) {
+                    double sum = 0.0;
+                    for (size_t p = 0; p < side; ++p) {
+                        sum += a[i][p] * b[p][j];
+                    }
+                    product[i][j] = sum;
+                }
+            }
+            doNotOptimize(product[0][0]);
+        });
+
+        runner.run("task3/multiply/blocked", elements, flops, bytes, [&] {
+            multiplyInto(a, b, product);
+            doNotOptimize(product[0][0]);
+        });
+
+        runner.run("task3/multiply/blocked_transposed", elements, flops, bytes, [&] {
+            multiplyTransposedInto(a, b, product);
+            doNotOptimize(product[0][0]);
+        });
+
+        runner.run("task3/multiply/parallel", elements, flops, bytes, [&] {
+            multiplyInto(sharedThreadPool(), a, b, product);
+            doNotOptimize(product[0][0]);
+        });
+
+        for (SimdLevel level : levels) {
+            setSimdLevel(level);
+            runner.run(string("task3/multiply/") + simdLevelName(level), elements, flops, bytes, [&] {
+                multiplyInto(a, b, product);
+                doNotOptimize(product[0][0]);
+            });
+        }
+        setSimdLevel(SimdLevel::AVX512);
+    }
+}
@@ -0,0 +1,45 @@
+#include <algorithm>
+#include <memory>
+
+#include "bench_harness.h"
+#include "task4.h"
+
+using namespace std;
+
+/**
+ * @brief Benchmarks std::sort against selectionSort, and searchAndPrint, for each size.
+ * Both sorts copy the unsorted input first, so the copy cost is the same on each side.
+ */
+void runTask4Benchmarks(BenchRunner& runner) {
+    const BenchConfig& config = runner.config();
+
+    vector<unique_ptr<OutputSink>> sinks;
+    sinks.push_back(make_unique<NullSink>());
+    DualOutputWriter output(move(sinks));
+
+    for (size_t n : config.sizes) {
+        const IntVector data = makeIntData(n, config.distribution, config.seed);
+        IntVector work(n);
+        const size_t bytes = 2 * n * sizeof(int);
+
+        runner.run("task4/std_sort", n, n, bytes, [&] {
+            copy(data.begin(), data.end(), work.begin());
+            sort(work.begin(), work.end());
+            doNotOptimize(work.front());
+        });
+
+        if (n <= config.selectionSortLimit) {
+            runner.run("task4/selectionSort", n, n, bytes, [&] {
+                copy(data.begin(), data.end(), work.begin());
+                selectionSort(work.data(), static_cast<int>(work.size()));
+                doNotOptimize(work.front());
+            });
+        }
+
+        const int key = n > 0 ? data[n / 2] : 0;
+        runner.run("task4/searchAndPrint", n, n, n * sizeof(int), [&] {
+            int found = searchAndPrint(data, key, output);
+            doNotOptimize(found);
+        });
+    }
+}
@@ -0,0 +1,61 @@
+#include "bench_harness.h"
+#include "task5.h"
+
+using namespace std;
+
+namespace {
+    /**
+     * @brief Fills a fixed-size task 5 matrix from generated data.
+     */
+    Matrix makeMatrix(const BenchConfig& config, uint64_t seed) {
+        vector<int> data = makeIntData(MATRIX_ROWS * MATRIX_COLS, config.distribution, seed);
+        Matrix matrix;
+        for (int i = 0; i < MATRIX_ROWS; ++i) {
+            for (int j = 0; j < MATRIX_COLS; ++j) {
+                matrix[i][j] = data[i * MATRIX_COLS + j];
+            }
+        }
+        return matrix;
+    }
+}
+
+/**
+ * @brief Benchmarks the Fibonacci recurrence and applyMatrixOperation.
+ * compute() is a single O(log n) jump; sequence() fills all terms up to n.
+ */
+void runTask5Benchmarks(BenchRunner& runner) {
+    const BenchConfig& config = runner.config();
+
+    constexpr int FIBONACCI_N = 90;  // Largest index that fits in long long
+    FibonacciCalculator fib;
+    runner.run("task5/FibonacciCalculator/compute", FIBONACCI_N, FIBONACCI_N + 1, 0, [&] {
+        long long value = fib.compute(FIBONACCI_N);
+        doNotOptimize(value);
+    });
+    runner.run("task5/FibonacciCalculator/sequence", FIBONACCI_N, FIBONACCI_N + 1, 0, [&] {
+        vector<long long> terms = fib.sequence(FIBONACCI_N);
+        doNotOptimize(terms.back());
+    });
+
+    // Terms modulo 2^64 far past the range of the task, generated in bulk
+    for (size_t n : config.sizes) {
+        vector<long long> terms(n);
+        runner.run("task5/recurrence/fill", n, n, n * sizeof(long long), [&] {
+            FIBONACCI.fill(1000000, n, terms.data());
+            doNotOptimize(terms.back());
+        });
+    }
+
+    const Matrix a = makeMatrix(config, config.seed);
+    const Matrix b = makeMatrix(config, config.seed + 1);
+    Matrix result;
+    constexpr size_t elements = MATRIX_ROWS * MATRIX_COLS;
+    constexpr size_t bytes = 3 * elements * sizeof(int);
+
+    for (char op : { '+', '-', '*', '/' }) {
+        runner.run(string("task5/applyMatrixOperation/") + op, elements, elements, bytes, [&] {
+            applyMatrixOperation(a, b, result, op);
+            doNotOptimize(result);
+        });
+    }
+}
@@ -0,0 +1,65 @@
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+#include "bench_harness.h"
+#include "task6.h"
+
+using namespace std;
+
+namespace {
+    const char* BENCH_DATABASE = "bench_students_database.txt";
+    const char* BENCH_OUTPUT = "bench_output_students.txt";
+
+    /**
+     * @brief Writes a database file with n valid, randomly generated students.
+     */
+    void writeDatabase(size_t n, uint64_t seed) {
+        static const char* surnames[] = { "Ivanov", "Petrov", "Sidorov", "Smirnov", "Kuznetsov",
+            "Popov", "Sokolov", "Lebedev", "Kozlov", "Novikov" };
+
+        mt19937_64 rng(seed);
+        uniform_int_distribution<int> surname(0, 9);
+        uniform_int_distribution<int> birthYear(1995, 2006);
+        uniform_int_distribution<int> studyYear(1, 4);
+        uniform_int_distribution<int> gpa(200, 500);
+
+        ofstream out(BENCH_DATABASE);
+        for (size_t i = 0; i < n; ++i) {
+            out << (1000 + i) << " " << surnames[surname(rng)] << " " << birthYear(rng) << " "
+                << studyYear(rng) << " " << gpa(rng) / 100.0 << "\n";
+        }
+    }
+}
+
+/**
+ * @brief Benchmarks StudentDatabase::search for each size.
+ * The search includes writing the result table, which goes to the current
+ * output mode (bench_main selects DISCARD).
+ */
+void runTask6Benchmarks(BenchRunner& runner) {
+    const BenchConfig& config = runner.config();
+
+    for (size_t n : config.sizes) {
+        if (!runner.enabled("task6/StudentDatabase/search/id")
+            && !runner.enabled("task6/StudentDatabase/search/gpa")) {
+            break;
+        }
+
+        writeDatabase(n, config.seed);
+        StudentDatabase db(BENCH_DATABASE, BENCH_OUTPUT);
+        const size_t bytes = n * sizeof(Student);
+
+        runner.run("task6/StudentDatabase/search/id", n, n, bytes, [&] {
+            const int id = static_cast<int>(1000 + n / 2);
+            db.search([id](const Student& s) { return s.id == id; }, "BENCH: ID");
+        });
+
+        runner.run("task6/StudentDatabase/search/gpa", n, n, bytes, [&] {
+            db.search([](const Student& s) { return s.gpa >= 4.5; }, "BENCH: GPA >= 4.5");
+        });
+    }
+
+    remove(BENCH_DATABASE);
+    remove(BENCH_OUTPUT);
+}
@@ -0,0 +1,120 @@
+#include "cpu_features.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#if LAB_X86 && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+    SimdLevel detect() {
+#if LAB_X86 && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        const bool sse2 = (info[3] & (1 << 26)) != 0;
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        if (!sse2) {
+            return SimdLevel::SCALAR;
+        }
+        if (!osxsave || maxLeaf < 7) {
+            return SimdLevel::SSE2;
+        }
+
+        // The OS must save YMM (bits 1-2) and, for AVX-512, opmask/ZMM state (bits 5-7)
+        const unsigned long long xcr0 = _xgetbv(0);
+        __cpuidex(info, 7, 0);
+        const bool avx2 = (info[1] & (1 << 5)) != 0 && fma && (xcr0 & 0x6) == 0x6;
+        const bool avx512 = (info[1] & (1 << 16)) != 0 && (xcr0 & 0xE6) == 0xE6;
+        if (avx2 && avx512) {
+            return SimdLevel::AVX512;
+        }
+        return avx2 ? SimdLevel::AVX2 : SimdLevel::SSE2;
+#elif LAB_X86
+        __builtin_cpu_init();
+        const bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        if (__builtin_cpu_supports("avx512f") && avx2) {
+            return SimdLevel::AVX512;
+        }
+        if (avx2) {
+            return SimdLevel::AVX2;
+        }
+        return __builtin_cpu_supports("sse2") ? SimdLevel::SSE2 : SimdLevel::SCALAR;
+#else
+        return SimdLevel::SCALAR;
+#endif
+    }
+
+    atomic<SimdLevel> g_cap{ SimdLevel::AVX512 };
+
+    // Assumed when the operating system does not report cache sizes
+    constexpr size_t DEFAULT_LLC_BYTES = size_t(8) << 20;
+
+    size_t detectLastLevelCache() {
+        size_t largest = 0;
+#ifdef _WIN32
+        DWORD length = 0;
+        GetLogicalProcessorInformation(nullptr, &length);
+        vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> entries(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+        if (!entries.empty() && GetLogicalProcessorInformation(entries.data(), &length)) {
+            for (const auto& entry : entries) {
+                if (entry.Relationship == RelationCache && entry.Cache.Type != CacheInstruction) {
+                    largest = max(largest, static_cast<size_t>(entry.Cache.Size));
+                }
+            }
+        }
+#elif defined(_SC_LEVEL3_CACHE_SIZE)
+        for (int name : { _SC_LEVEL3_CACHE_SIZE, _SC_LEVEL2_CACHE_SIZE }) {
+            const long size = sysconf(name);
+            if (size > 0) {
+                largest = max(largest, static_cast<size_t>(size));
+            }
+        }
+#endif
+        return (largest != 0) ? largest : DEFAULT_LLC_BYTES;
+    }
+}
+
+SimdLevel detectedSimdLevel() {
+    static const SimdLevel level = detect();
+    return level;
+}
+
+SimdLevel simdLevel() {
+    return min(detectedSimdLevel(), g_cap.load(memory_order_relaxed));
+}
+
+void setSimdLevel(SimdLevel level) {
+    g_cap.store(level, memory_order_relaxed);
+}
+
+size_t lastLevelCacheBytes() {
+    static const size_t bytes = detectLastLevelCache();
+    return bytes;
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::SCALAR: return "scalar";
+    case SimdLevel::SSE2: return "sse2";
+    case SimdLevel::AVX2: return "avx2";
+    case SimdLevel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
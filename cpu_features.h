@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+
+// x86 targets get SIMD kernels; everything else runs the scalar ones
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define LAB_X86 1
+#else
+#define LAB_X86 0
+#endif
+
+// Compiles one function for a wider instruction set than the rest of the file.
+// MSVC accepts AVX intrinsics anywhere, GCC and Clang need the target attribute.
+#if defined(__GNUC__) || defined(__clang__)
+#define LAB_TARGET(isa) __attribute__((target(isa)))
+#else
+#define LAB_TARGET(isa)
+#endif
+
+// Fully unrolls the next loop, whose trip count must be a constant, so that
+// arrays of vector accumulators indexed by it stay in registers
+#if defined(__clang__)
+#define LAB_UNROLL _Pragma("clang loop unroll(full)")
+#elif defined(__GNUC__)
+#define LAB_UNROLL _Pragma("GCC unroll 16")
+#else
+#define LAB_UNROLL
+#endif
+
+// Lets GCC vectorize loops with floating-point compares, which it otherwise
+// keeps scalar in case an FP exception traps (the default environment never traps).
+// Clang and MSVC vectorize them without it.
+#if defined(__GNUC__) && !defined(__clang__)
+#define LAB_NO_TRAPPING_MATH __attribute__((optimize("no-trapping-math")))
+#else
+#define LAB_NO_TRAPPING_MATH
+#endif
+
+// Promises that a pointer parameter does not alias the others, so loops over
+// it vectorize without runtime overlap checks (MSVC, GCC and Clang all accept it)
+#define LAB_RESTRICT __restrict
+
+/**
+ * @brief Instruction sets a kernel can be dispatched to, in increasing width.
+ */
+enum class SimdLevel {
+    SCALAR,
+    SSE2,
+    AVX2,       ///< AVX2 together with FMA, as on every CPU that has AVX2
+    AVX512
+};
+
+/**
+ * @brief Widest level supported by the CPU and the operating system (detected once).
+ */
+SimdLevel detectedSimdLevel();
+
+/**
+ * @brief Level kernels dispatch to: the detected one unless lowered by setSimdLevel().
+ */
+SimdLevel simdLevel();
+
+/**
+ * @brief Caps the dispatch level, e.g. to compare kernels; capped at detectedSimdLevel().
+ */
+void setSimdLevel(SimdLevel level);
+
+const char* simdLevelName(SimdLevel level);
+
+/**
+ * @brief Size in bytes of the largest data cache (detected once; 8 MiB if unknown).
+ * Kernels whose working set exceeds it are bound by memory bandwidth rather than by the core.
+ */
+std::size_t lastLevelCacheBytes();
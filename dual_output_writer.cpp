@@ -0,0 +1,334 @@
+#include "dual_output_writer.h"
+#include "instrumentation.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+// ============================================================================
+// ASYNC OUTPUT BUFFER
+// ============================================================================
+
+AsyncOutputBuffer::AsyncOutputBuffer(vector<unique_ptr<OutputSink>> sinks)
+    : sinks_(move(sinks)) {
+    for (auto& slot : slots_) {
+        slot.data.resize(BUFFER_SIZE);
+    }
+    acquire();
+    flusher_ = thread(&AsyncOutputBuffer::flushLoop, this);
+}
+
+AsyncOutputBuffer::~AsyncOutputBuffer() {
+    try {
+        close();
+    }
+    catch (...) {
+        // Destructors must not throw; close() reports the error to callers that ask
+    }
+}
+
+/**
+ * @brief Hands the current buffer to the flush thread.
+ * @param last Marks the buffer as the final one; the flush thread exits after it
+ */
+void AsyncOutputBuffer::publish(bool last) {
+    size_t head = head_.load(memory_order_relaxed);
+    Slot& slot = slots_[head % BUFFER_COUNT];
+    slot.size = static_cast<size_t>(pptr() - pbase());
+    slot.last = last;
+    setp(nullptr, nullptr);
+
+    head_.store(head + 1, memory_order_release);
+    head_.notify_one();
+}
+
+/**
+ * @brief Makes the next free slot the put area, waiting if the ring is full.
+ */
+void AsyncOutputBuffer::acquire() {
+    size_t head = head_.load(memory_order_relaxed);
+    size_t tail = tail_.load(memory_order_acquire);
+    while (head - tail >= BUFFER_COUNT) {
+        tail_.wait(tail, memory_order_acquire);
+        tail = tail_.load(memory_order_acquire);
+    }
+
+    char* begin = slots_[head % BUFFER_COUNT].data.data();
+    setp(begin, begin + BUFFER_SIZE);
+    rethrowIfFailed();
+}
+
+/**
+ * @brief Rethrows the exception a sink threw on the flush thread.
+ * The producer always owns a slot when this throws, so close() still works.
+ */
+void AsyncOutputBuffer::rethrowIfFailed() const {
+    if (failed_.load(memory_order_acquire)) {
+        rethrow_exception(error_);
+    }
+}
+
+/**
+ * @brief Body of the flush thread: writes published buffers to every sink.
+ * Sinks are flushed whenever the ring runs empty, so a waiting producer
+ * sees its output on the terminal before it prompts the user.
+ * After a sink throws, the remaining buffers are released unwritten.
+ */
+void AsyncOutputBuffer::flushLoop() {
+    size_t tail = tail_.load(memory_order_relaxed);
+
+    while (true) {
+        size_t head = head_.load(memory_order_acquire);
+        if (tail == head) {
+            head_.wait(head, memory_order_acquire);
+            continue;
+        }
+
+        const Slot& slot = slots_[tail % BUFFER_COUNT];
+        const bool last = slot.last;
+        ++tail;
+        if (!failed_.load(memory_order_relaxed)) {
+            LAB_PHASE(Phase::WRITE);
+            try {
+                if (slot.size > 0) {
+                    for (auto& sink : sinks_) {
+                        sink->write(slot.data.data(), slot.size);
+                    }
+                    bytesWritten_.fetch_add(slot.size, memory_order_relaxed);
+                    LAB_COUNT(Counter::BYTES_OUT, slot.size);
+                }
+
+                if (last || tail == head_.load(memory_order_acquire)) {
+                    for (auto& sink : sinks_) {
+                        sink->flush();
+                    }
+                    flushCount_.fetch_add(1, memory_order_relaxed);
+                }
+            }
+            catch (...) {
+                error_ = current_exception();
+                failed_.store(true, memory_order_release);
+            }
+        }
+
+        tail_.store(tail, memory_order_release);
+        tail_.notify_one();
+
+        if (last) {
+            return;
+        }
+    }
+}
+
+AsyncOutputBuffer::int_type AsyncOutputBuffer::overflow(int_type ch) {
+    if (closed_) {
+        return traits_type::eof();
+    }
+    rethrowIfFailed();
+
+    publish(false);
+    acquire();
+
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+streamsize AsyncOutputBuffer::xsputn(const char* s, streamsize count) {
+    rethrowIfFailed();
+    streamsize written = 0;
+    while (written < count) {
+        if (pptr() == epptr() && traits_type::eq_int_type(overflow(traits_type::eof()), traits_type::eof())) {
+            break;
+        }
+
+        streamsize chunk = min(count - written, static_cast<streamsize>(epptr() - pptr()));
+        memcpy(pptr(), s + written, static_cast<size_t>(chunk));
+        pbump(static_cast<int>(chunk));
+        written += chunk;
+    }
+    return written;
+}
+
+char* AsyncOutputBuffer::reserve(size_t size) {
+    if (closed_) {
+        return nullptr;
+    }
+    rethrowIfFailed();
+
+    if (static_cast<size_t>(epptr() - pptr()) < size) {
+        publish(false);
+        acquire();
+    }
+    return pptr();
+}
+
+/**
+ * @brief Stream flush requests (endl, flush) are absorbed to keep the producer non-blocking.
+ */
+int AsyncOutputBuffer::sync() {
+    return 0;
+}
+
+void AsyncOutputBuffer::drain() {
+    if (closed_) {
+        return;
+    }
+    rethrowIfFailed();
+
+    if (pptr() != pbase()) {
+        publish(false);
+        acquire();
+    }
+
+    size_t head = head_.load(memory_order_relaxed);
+    size_t tail = tail_.load(memory_order_acquire);
+    while (tail != head) {
+        tail_.wait(tail, memory_order_acquire);
+        tail = tail_.load(memory_order_acquire);
+    }
+    rethrowIfFailed();
+}
+
+vector<unique_ptr<OutputSink>>& AsyncOutputBuffer::drainedSinks() {
+    drain();
+    return sinks_;
+}
+
+void AsyncOutputBuffer::close() {
+    if (closed_) {
+        return;
+    }
+    closed_ = true;
+
+    publish(true);
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+    rethrowIfFailed();
+}
+
+OutputStats AsyncOutputBuffer::stats() const {
+    return { bytesWritten_.load(memory_order_relaxed), flushCount_.load(memory_order_relaxed) };
+}
+
+// ============================================================================
+// DUAL OUTPUT WRITER
+// ============================================================================
+
+DualOutputWriter::DualOutputWriter(const string& filepath, bool append)
+    : DualOutputWriter(makeSinks(filepath, append)) {
+}
+
+DualOutputWriter::DualOutputWriter(vector<unique_ptr<OutputSink>> sinks)
+    : buffer_(move(sinks)),
+    stream_(&buffer_) {
+    stream_.exceptions(ios::badbit);  // Pass sink errors on instead of only setting badbit
+}
+
+DualOutputWriter::~DualOutputWriter() {
+    try {
+        buffer_.close();
+    }
+    catch (...) {
+        // Destructors must not throw; close() reports the error to callers that ask
+    }
+}
+
+DualOutputWriter& DualOutputWriter::writeGeneral(const double* values, size_t count, char separator) {
+    constexpr size_t FIELD_SIZE = fast_format::MAX_GENERAL_CHARS + 6 + 1;  // Precision 6 and separator
+    constexpr size_t BLOCK_VALUES = AsyncOutputBuffer::BUFFER_SIZE / FIELD_SIZE;
+
+    while (count > 0) {
+        // Fill what is left of the current buffer before asking for a new one
+        size_t block = min(count, buffer_.available() / FIELD_SIZE);
+        if (block == 0) {
+            block = min(count, BLOCK_VALUES);
+        }
+
+        char* out = buffer_.reserve(block * FIELD_SIZE);
+        if (out == nullptr) {
+            break;
+        }
+
+        char* end = out;
+        for (size_t i = 0; i < block; ++i) {
+            end = fast_format::formatField(end, generalField(values[i]));
+            *end++ = separator;
+        }
+        buffer_.commit(static_cast<size_t>(end - out));
+
+        values += block;
+        count -= block;
+    }
+    return *this;
+}
+
+DualOutputWriter& DualOutputWriter::writeChunks(ThreadPool& pool, long long count, long long chunkSize,
+    const ChunkFormatter& format) {
+    if (count <= 0) {
+        return *this;
+    }
+    chunkSize = max(chunkSize, 1LL);
+
+    vector<unique_ptr<OutputSink>>& sinks = buffer_.drainedSinks();
+    const bool positional = all_of(sinks.begin(), sinks.end(),
+        [](const unique_ptr<OutputSink>& sink) { return sink->positional(); });
+
+    // Chunks are processed in waves, which bounds the memory held in private buffers
+    const long long chunks = (count + chunkSize - 1) / chunkSize;
+    const long long wave = min(chunks, static_cast<long long>(4 * pool.size()));
+    vector<string> texts(static_cast<size_t>(wave));
+    vector<size_t> offsets(texts.size() + 1);
+    vector<future<void>> pending;
+
+    for (long long firstChunk = 0; firstChunk < chunks; firstChunk += wave) {
+        const size_t waveChunks = static_cast<size_t>(min(wave, chunks - firstChunk));
+
+        pending.clear();
+        for (size_t i = 0; i < waveChunks; ++i) {
+            pending.push_back(pool.submit([&, i]() {
+                const long long first = (firstChunk + static_cast<long long>(i)) * chunkSize;
+                texts[i].clear();
+                format(first, min(chunkSize, count - first), texts[i]);
+            }));
+        }
+        ThreadPool::waitAll(pending);
+
+        offsets[0] = 0;
+        for (size_t i = 0; i < waveChunks; ++i) {
+            offsets[i + 1] = offsets[i] + texts[i].size();
+        }
+        const size_t total = offsets[waveChunks];
+
+        if (!positional) {
+            for (size_t i = 0; i < waveChunks; ++i) {
+                stream_.write(texts[i].data(), static_cast<streamsize>(texts[i].size()));
+            }
+            continue;
+        }
+
+        for (auto& sink : sinks) {
+            sink->beginPositional(total);
+        }
+        pending.clear();
+        for (size_t i = 0; i < waveChunks; ++i) {
+            pending.push_back(pool.submit([&, i]() {
+                LAB_PHASE(Phase::WRITE);
+                for (auto& sink : sinks) {
+                    sink->writeAt(offsets[i], texts[i].data(), texts[i].size());
+                }
+            }));
+        }
+        ThreadPool::waitAll(pending);
+        for (auto& sink : sinks) {
+            sink->endPositional();
+        }
+        buffer_.countWritten(total);
+        LAB_COUNT(Counter::BYTES_OUT, total);
+    }
+    return *this;
+}
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fast_format.h"
+#include "output_sink.h"
+#include "thread_pool.h"
+
+/**
+ * @brief Counters reported by DualOutputWriter about its background flush thread.
+ */
+struct OutputStats {
+    std::size_t bytesWritten = 0;   ///< Bytes delivered to every sink
+    std::size_t flushCount = 0;     ///< Number of times the sinks were flushed
+};
+
+/**
+ * @brief Ring of fixed-size buffers drained by a background thread.
+ * The producer (task code) formats into the current buffer through the
+ * std::streambuf interface; full buffers are handed to the flush thread
+ * through a single-producer/single-consumer ring without locks.
+ * The flush thread forwards every buffer to each OutputSink in turn.
+ * If a sink throws, the flush thread keeps the exception and drops the rest
+ * of the output; the producer gets the exception from its next write,
+ * drain() or close().
+ */
+class AsyncOutputBuffer : public std::streambuf {
+public:
+    static constexpr std::size_t BUFFER_COUNT = 4;
+    static constexpr std::size_t BUFFER_SIZE = 64 * 1024;
+
+    /**
+     * @brief Starts the flush thread writing to the given sinks.
+     * @param sinks Destinations receiving every byte, in order
+     */
+    explicit AsyncOutputBuffer(std::vector<std::unique_ptr<OutputSink>> sinks);
+
+    /**
+     * @brief Publishes pending data and joins the flush thread.
+     * A sink error not yet reported is dropped; call close() to get it.
+     */
+    ~AsyncOutputBuffer() override;
+
+    AsyncOutputBuffer(const AsyncOutputBuffer&) = delete;
+    AsyncOutputBuffer& operator=(const AsyncOutputBuffer&) = delete;
+
+    /**
+     * @brief Blocks until everything written so far has reached the sinks.
+     * @throws The exception a sink threw on the flush thread, if any
+     */
+    void drain();
+
+    /**
+     * @brief Drains the ring and hands the sinks to the producer.
+     * The flush thread does not touch the sinks while the ring is empty, so
+     * they may be used directly until the next byte goes through the stream.
+     */
+    std::vector<std::unique_ptr<OutputSink>>& drainedSinks();
+
+    /**
+     * @brief Adds bytes written to the sinks outside the ring to stats().
+     */
+    void countWritten(std::size_t size) {
+        bytesWritten_.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Publishes the last buffer and waits for the flush thread to exit.
+     * At most BUFFER_COUNT buffers can be pending, which bounds the time spent here.
+     * @throws The exception a sink threw on the flush thread, if any
+     */
+    void close();
+
+    /**
+     * @brief Returns a snapshot of the flush thread counters.
+     */
+    OutputStats stats() const;
+
+    /**
+     * @brief Returns a contiguous area of at least size bytes in the current buffer.
+     * Publishes the current buffer first if it has less room left.
+     * @param size Bytes needed, at most BUFFER_SIZE
+     * @return Pointer to write to, or nullptr once the buffer is closed
+     */
+    char* reserve(std::size_t size);
+
+    /**
+     * @brief Marks size bytes written through reserve() as part of the stream.
+     */
+    void commit(std::size_t size) {
+        pbump(static_cast<int>(size));
+    }
+
+    /**
+     * @brief Returns the bytes left in the current buffer.
+     */
+    std::size_t available() const {
+        return static_cast<std::size_t>(epptr() - pptr());
+    }
+
+protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char* s, std::streamsize count) override;
+    int sync() override;
+
+private:
+    struct Slot {
+        std::vector<char> data;
+        std::size_t size = 0;
+        bool last = false;
+    };
+
+    void publish(bool last);
+    void acquire();
+    void flushLoop();
+    void rethrowIfFailed() const;
+
+    std::vector<std::unique_ptr<OutputSink>> sinks_;
+    std::array<Slot, BUFFER_COUNT> slots_;
+    std::atomic<std::size_t> head_{ 0 };    ///< Buffers published by the producer
+    std::atomic<std::size_t> tail_{ 0 };    ///< Buffers drained by the flush thread
+    std::atomic<std::size_t> bytesWritten_{ 0 };
+    std::atomic<std::size_t> flushCount_{ 0 };
+    std::exception_ptr error_;              ///< First exception thrown by a sink
+    std::atomic<bool> failed_{ false };     ///< Set by the flush thread after error_
+    bool closed_ = false;
+    std::thread flusher_;
+};
+
+/**
+ * @brief Helper class for dual output to console and file simultaneously.
+ * Eliminates code duplication by combining cout and file write operations.
+ * Automatically manages file lifecycle through RAII pattern.
+ *
+ * Formatting happens on the caller's thread into an AsyncOutputBuffer, so the
+ * caller never waits on the terminal; a background thread writes the bytes.
+ * Call flush() before prompting the user on cout directly.
+ *
+ * Where the bytes go is decided by the sinks: by default console and file,
+ * or whatever the current OutputMode selects (file only, memory, discard).
+ */
+class DualOutputWriter {
+private:
+    AsyncOutputBuffer buffer_;
+    std::ostream stream_;
+
+public:
+    /**
+     * @brief Constructs DualOutputWriter with file path and optional append mode.
+     * @param filepath Path to the output file
+     * @param append If true, appends to existing file; otherwise overwrites
+     * @throws runtime_error if file cannot be opened
+     * @note Sinks are chosen by the current OutputMode (see setOutputMode()).
+     */
+    explicit DualOutputWriter(const std::string& filepath, bool append = false);
+
+    /**
+     * @brief Constructs DualOutputWriter over an explicit set of sinks.
+     * @param sinks Destinations receiving every byte, in order
+     */
+    explicit DualOutputWriter(std::vector<std::unique_ptr<OutputSink>> sinks);
+
+    /**
+     * @brief Destructor flushes pending output and closes the sinks (RAII pattern).
+     * Sink errors are not reported here; call close() first to get them.
+     */
+    ~DualOutputWriter();
+
+    DualOutputWriter(const DualOutputWriter&) = delete;
+    DualOutputWriter& operator=(const DualOutputWriter&) = delete;
+
+    /**
+     * @brief Outputs data to both console and file simultaneously.
+     * @tparam T Data type to output
+     * @param data Data to write
+     * @return Reference to this object for method chaining
+     */
+    template<typename T>
+    DualOutputWriter& operator<<(const T& data) {
+        stream_ << data;
+        return *this;
+    }
+
+    /**
+     * @brief Specialization for stream manipulators (endl, setprecision, etc.).
+     * @note endl does not wait for the sinks; use flush() for that.
+     */
+    DualOutputWriter& operator<<(std::ostream& (*manip)(std::ostream&)) {
+        stream_ << manip;
+        return *this;
+    }
+
+    /**
+     * @brief Fast paths for fixedField(), intField() and generalField().
+     * Format with std::to_chars straight into the output buffer, bypassing
+     * iostream locale and facet machinery; bytes match the setw/setprecision path.
+     * Sticky stream state (fixed, setprecision) is neither used nor changed.
+     */
+    DualOutputWriter& operator<<(const FixedField& field) {
+        return writeField(field);
+    }
+
+    DualOutputWriter& operator<<(const IntField& field) {
+        return writeField(field);
+    }
+
+    DualOutputWriter& operator<<(const GeneralField& field) {
+        return writeField(field);
+    }
+
+    /**
+     * @brief Writes each value as generalField(value) followed by separator.
+     * Same bytes as the per-value operator<<, but buffer space is reserved
+     * once per block of values instead of once per value.
+     * @param values Values to write
+     * @param count Number of values
+     * @param separator Character written after every value
+     */
+    DualOutputWriter& writeGeneral(const double* values, std::size_t count, char separator = ' ');
+
+    /**
+     * @brief Formats items [0, count) into string chunks of chunkSize items.
+     * Called from several threads at once, each with its own string.
+     */
+    using ChunkFormatter = std::function<void(long long first, long long count, std::string& out)>;
+
+    /**
+     * @brief Formats items [0, count) in parallel and appends them in order.
+     * Chunks are formatted on the pool into private buffers; a prefix sum of
+     * their lengths gives every chunk its final offset. When all sinks are
+     * positional (file, mapped file, null) the chunks are also written in
+     * parallel at those offsets; otherwise they go through the stream in
+     * order. Either way the bytes equal a sequential run of format().
+     * @param pool Pool to run on
+     * @param count Number of items
+     * @param chunkSize Items per chunk
+     * @param format Formatter for one chunk
+     */
+    DualOutputWriter& writeChunks(ThreadPool& pool, long long count, long long chunkSize,
+        const ChunkFormatter& format);
+
+    /**
+     * @brief Waits until all output written so far is visible on console and in file.
+     * @throws The exception a sink threw while writing earlier output, if any
+     */
+    void flush() {
+        buffer_.drain();
+    }
+
+    /**
+     * @brief Writes the remaining output and closes the sinks.
+     * @throws The exception a sink threw while writing, if any
+     */
+    void close() {
+        buffer_.close();
+    }
+
+    /**
+     * @brief Returns the number of bytes written and flushes performed so far.
+     */
+    OutputStats stats() const {
+        return buffer_.stats();
+    }
+
+private:
+    template<typename Field>
+    DualOutputWriter& writeField(const Field& field) {
+        std::size_t size = fast_format::maxSize(field);
+        if (size > AsyncOutputBuffer::BUFFER_SIZE) {
+            std::vector<char> scratch(size);
+            char* end = fast_format::formatField(scratch.data(), field);
+            stream_.write(scratch.data(), end - scratch.data());
+            return *this;
+        }
+
+        if (char* out = buffer_.reserve(size)) {
+            buffer_.commit(static_cast<std::size_t>(fast_format::formatField(out, field) - out));
+        }
+        return *this;
+    }
+};
@@ -0,0 +1,127 @@
+#include "dynamic_matrix.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+namespace {
+    /**
+     * @brief Address range [first, last) covered by the elements of a non-empty view.
+     */
+    pair<uintptr_t, uintptr_t> addressRange(ConstMatrixView view) {
+        const uintptr_t first = reinterpret_cast<uintptr_t>(view.data());
+        const size_t elements = (view.rows() - 1) * view.stride() + view.cols();
+        return { first, first + elements * sizeof(double) };
+    }
+}
+
+bool viewsOverlap(ConstMatrixView first, ConstMatrixView second) {
+    if (first.empty() || second.empty()) {
+        return false;
+    }
+    const auto [firstBegin, firstEnd] = addressRange(first);
+    const auto [secondBegin, secondEnd] = addressRange(second);
+    return firstBegin < secondEnd && secondBegin < firstEnd;
+}
+
+void DynamicMatrix::AlignedDelete::operator()(double* data) const {
+    ::operator delete[](data, align_val_t(MATRIX_ALIGNMENT));
+}
+
+unique_ptr<double[], DynamicMatrix::AlignedDelete> DynamicMatrix::allocate(size_t elements) {
+    if (elements == 0) {
+        return nullptr;
+    }
+    void* storage = ::operator new[](elements * sizeof(double), align_val_t(MATRIX_ALIGNMENT));
+    return unique_ptr<double[], AlignedDelete>(static_cast<double*>(storage));
+}
+
+DynamicMatrix::DynamicMatrix(size_t rows, size_t cols) {
+    resize(rows, cols);
+}
+
+DynamicMatrix::DynamicMatrix(const DynamicMatrix& other)
+    : data_(allocate(other.rows_ * other.stride_)),
+      rows_(other.rows_), cols_(other.cols_), stride_(other.stride_),
+      capacity_(other.rows_ * other.stride_) {
+    // Only the elements are copied: other's padding may be uninitialized
+    for (size_t i = 0; i < rows_; ++i) {
+        copy_n(other[i], cols_, (*this)[i]);
+        fill_n((*this)[i] + cols_, stride_ - cols_, 0.0);
+    }
+}
+
+DynamicMatrix& DynamicMatrix::operator=(const DynamicMatrix& other) {
+    if (this != &other) {
+        DynamicMatrix copy(other);
+        *this = move(copy);
+    }
+    return *this;
+}
+
+DynamicMatrix::DynamicMatrix(DynamicMatrix&& other) noexcept
+    : data_(move(other.data_)),
+      rows_(exchange(other.rows_, 0)), cols_(exchange(other.cols_, 0)),
+      stride_(exchange(other.stride_, 0)), capacity_(exchange(other.capacity_, 0)) {
+}
+
+DynamicMatrix& DynamicMatrix::operator=(DynamicMatrix&& other) noexcept {
+    data_ = move(other.data_);
+    rows_ = exchange(other.rows_, 0);
+    cols_ = exchange(other.cols_, 0);
+    stride_ = exchange(other.stride_, 0);
+    capacity_ = exchange(other.capacity_, 0);
+    return *this;
+}
+
+namespace {
+    /**
+     * @brief rows * paddedStride(cols), the elements a matrix of that shape occupies.
+     * @throws length_error if the size overflows size_t
+     */
+    size_t storageSize(size_t rows, size_t cols) {
+        const size_t stride = DynamicMatrix::paddedStride(cols);
+        if (stride < cols || (stride != 0 && rows > numeric_limits<size_t>::max() / sizeof(double) / stride)) {
+            throw length_error("Matrix dimensions too large");
+        }
+        return rows * stride;
+    }
+}
+
+void DynamicMatrix::resize(size_t rows, size_t cols) {
+    const size_t stride = paddedStride(cols);
+    const size_t elements = storageSize(rows, cols);
+    if (elements > capacity_) {
+        data_ = allocate(elements);
+        capacity_ = elements;
+    }
+    rows_ = rows;
+    cols_ = cols;
+    stride_ = stride;
+    fill_n(data(), elements, 0.0);
+}
+
+DynamicMatrix DynamicMatrix::uninitialized(size_t rows, size_t cols) {
+    DynamicMatrix matrix;
+    const size_t elements = storageSize(rows, cols);
+    matrix.data_ = allocate(elements);
+    matrix.rows_ = rows;
+    matrix.cols_ = cols;
+    matrix.stride_ = paddedStride(cols);
+    matrix.capacity_ = elements;
+    return matrix;
+}
+
+void DynamicMatrix::reshapeInPlace(size_t rows, size_t cols) {
+    if (storageSize(rows, cols) > capacity_) {
+        throw length_error("Matrix shape does not fit the storage");
+    }
+    rows_ = rows;
+    cols_ = cols;
+    stride_ = paddedStride(cols);
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+// Alignment of the storage and of every row, one cache line (and one AVX-512 register)
+constexpr std::size_t MATRIX_ALIGNMENT = 64;
+
+// Doubles per aligned unit; row strides are rounded up to a multiple of this
+constexpr std::size_t MATRIX_ROW_QUANTUM = MATRIX_ALIGNMENT / sizeof(double);
+
+/**
+ * @brief Non-owning view of a row-major matrix with a row stride.
+ * Element (i, j) is at data()[i * stride() + j]. Views of a DynamicMatrix
+ * have an aligned, padded stride; sub-blocks keep the parent's stride.
+ * @tparam T double or const double
+ */
+template<typename T>
+class BasicMatrixView {
+public:
+    BasicMatrixView() = default;
+
+    BasicMatrixView(T* data, std::size_t rows, std::size_t cols, std::size_t stride)
+        : data_(data), rows_(rows), cols_(cols), stride_(stride) {
+    }
+
+    /**
+     * @brief A mutable view converts to a read-only one.
+     */
+    template<typename U>
+    BasicMatrixView(const BasicMatrixView<U>& other)
+        : data_(other.data()), rows_(other.rows()), cols_(other.cols()), stride_(other.stride()) {
+    }
+
+    T* data() const {
+        return data_;
+    }
+
+    std::size_t rows() const {
+        return rows_;
+    }
+
+    std::size_t cols() const {
+        return cols_;
+    }
+
+    /**
+     * @brief Distance in elements between the starts of consecutive rows.
+     */
+    std::size_t stride() const {
+        return stride_;
+    }
+
+    bool empty() const {
+        return rows_ == 0 || cols_ == 0;
+    }
+
+    /**
+     * @brief Pointer to the first element of row i, so view[i][j] reads element (i, j).
+     */
+    T* operator[](std::size_t i) const {
+        return data_ + i * stride_;
+    }
+
+    T& operator()(std::size_t i, std::size_t j) const {
+        return data_[i * stride_ + j];
+    }
+
+    /**
+     * @brief View of rows firstRow .. firstRow + rowCount - 1 and columns firstCol .. firstCol + colCount - 1.
+     */
+    BasicMatrixView block(std::size_t firstRow, std::size_t firstCol, std::size_t rowCount, std::size_t colCount) const {
+        return BasicMatrixView(data_ + firstRow * stride_ + firstCol, rowCount, colCount, stride_);
+    }
+
+    template<typename U>
+    bool sameShape(const BasicMatrixView<U>& other) const {
+        return rows_ == other.rows() && cols_ == other.cols();
+    }
+
+private:
+    T* data_ = nullptr;
+    std::size_t rows_ = 0;
+    std::size_t cols_ = 0;
+    std::size_t stride_ = 0;
+};
+
+using MatrixView = BasicMatrixView<double>;
+using ConstMatrixView = BasicMatrixView<const double>;
+
+/**
+ * @brief Whether the memory spanned by two views intersects (an empty view spans none).
+ * Kernels that read one view while writing the other reject overlapping views.
+ */
+bool viewsOverlap(ConstMatrixView first, ConstMatrixView second);
+
+/**
+ * @brief Row-major matrix of doubles sized at run time.
+ * The storage is one contiguous block aligned to MATRIX_ALIGNMENT, and every
+ * row is padded to a multiple of MATRIX_ROW_QUANTUM elements, so each row
+ * starts on a cache line and SIMD loops can run over whole padded rows
+ * without a scalar tail. Padding is zero after construction and copying (other
+ * than by uninitialized()); kernels may write to it but must not rely on its contents.
+ *
+ * matrix[i][j] works as with the nested std::array it replaces; kernels take
+ * MatrixView / ConstMatrixView, to which a matrix converts implicitly.
+ */
+class DynamicMatrix {
+public:
+    DynamicMatrix() = default;
+
+    /**
+     * @brief Allocates a rows x cols matrix filled with zeros.
+     * @throws length_error if the size overflows size_t
+     */
+    DynamicMatrix(std::size_t rows, std::size_t cols);
+
+    /**
+     * @brief Allocates a rows x cols matrix without initializing any element or padding.
+     * For results a kernel overwrites entirely: the pages of a large allocation
+     * are then first touched, and so placed on a NUMA node, by the threads that
+     * compute them instead of by the allocating thread.
+     * @throws length_error if the size overflows size_t
+     */
+    static DynamicMatrix uninitialized(std::size_t rows, std::size_t cols);
+
+    DynamicMatrix(const DynamicMatrix& other);
+    DynamicMatrix& operator=(const DynamicMatrix& other);
+    DynamicMatrix(DynamicMatrix&& other) noexcept;
+    DynamicMatrix& operator=(DynamicMatrix&& other) noexcept;
+
+    /**
+     * @brief Reallocates as a zero-filled rows x cols matrix (keeps the storage if the size fits).
+     */
+    void resize(std::size_t rows, std::size_t cols);
+
+    /**
+     * @brief Gives the storage a new shape without moving or clearing any element.
+     * For in-place algorithms that rearrange the elements themselves; the
+     * stride becomes paddedStride(cols).
+     * @throws length_error if the new shape does not fit capacity()
+     */
+    void reshapeInPlace(std::size_t rows, std::size_t cols);
+
+    /**
+     * @brief Elements the storage holds without reallocating.
+     */
+    std::size_t capacity() const {
+        return capacity_;
+    }
+
+    std::size_t rows() const {
+        return rows_;
+    }
+
+    std::size_t cols() const {
+        return cols_;
+    }
+
+    std::size_t stride() const {
+        return stride_;
+    }
+
+    bool empty() const {
+        return rows_ == 0 || cols_ == 0;
+    }
+
+    double* data() {
+        return data_.get();
+    }
+
+    const double* data() const {
+        return data_.get();
+    }
+
+    double* operator[](std::size_t i) {
+        return data_.get() + i * stride_;
+    }
+
+    const double* operator[](std::size_t i) const {
+        return data_.get() + i * stride_;
+    }
+
+    double& operator()(std::size_t i, std::size_t j) {
+        return data_[i * stride_ + j];
+    }
+
+    double operator()(std::size_t i, std::size_t j) const {
+        return data_[i * stride_ + j];
+    }
+
+    MatrixView view() {
+        return MatrixView(data(), rows_, cols_, stride_);
+    }
+
+    ConstMatrixView view() const {
+        return ConstMatrixView(data(), rows_, cols_, stride_);
+    }
+
+    operator MatrixView() {
+        return view();
+    }
+
+    operator ConstMatrixView() const {
+        return view();
+    }
+
+    /**
+     * @brief Row stride used for a matrix with cols columns.
+     */
+    static std::size_t paddedStride(std::size_t cols) {
+        return (cols + MATRIX_ROW_QUANTUM - 1) / MATRIX_ROW_QUANTUM * MATRIX_ROW_QUANTUM;
+    }
+
+private:
+    struct AlignedDelete {
+        void operator()(double* data) const;
+    };
+
+    static std::unique_ptr<double[], AlignedDelete> allocate(std::size_t elements);
+
+    std::unique_ptr<double[], AlignedDelete> data_;
+    std::size_t rows_ = 0;
+    std::size_t cols_ = 0;
+    std::size_t stride_ = 0;
+    std::size_t capacity_ = 0;      ///< Allocated elements, at least rows_ * stride_
+};
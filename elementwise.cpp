@@ -0,0 +1,445 @@
+#include "elementwise.h"
+
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#if LAB_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+template void elementwise_detail::transformBands<AddOp>(ThreadPool*, ConstMatrixView, ConstMatrixView, MatrixView, const AddOp&);
+template void elementwise_detail::transformBands<SubtractOp>(ThreadPool*, ConstMatrixView, ConstMatrixView, MatrixView, const SubtractOp&);
+template void elementwise_detail::transformBands<MultiplyOp>(ThreadPool*, ConstMatrixView, ConstMatrixView, MatrixView, const MultiplyOp&);
+template void elementwise_detail::transformBands<SafeDivideOp>(ThreadPool*, ConstMatrixView, ConstMatrixView, MatrixView, const SafeDivideOp&);
+template void elementwise_detail::transformBands<MaxOp>(ThreadPool*, ConstMatrixView, ConstMatrixView, MatrixView, const MaxOp&);
+
+namespace {
+    // Bands per pool worker, so that uneven bands still balance
+    constexpr size_t BANDS_PER_WORKER = 4;
+}
+
+namespace elementwise_detail {
+    void forEachRowBand(ThreadPool* pool, size_t rows, size_t cols, const RowBandBody& body) {
+        const size_t workers = (pool != nullptr) ? pool->size() : 1;
+        const size_t bands = min({ rows, workers * BANDS_PER_WORKER, rows * cols / PARALLEL_GRAIN_ELEMENTS });
+        if (workers < 2 || bands < 2) {
+            body(0, rows);
+            return;
+        }
+
+        const size_t rowsPerBand = (rows + bands - 1) / bands;
+        vector<future<void>> pending;
+        pending.reserve(bands);
+        for (size_t firstRow = 0; firstRow < rows; firstRow += rowsPerBand) {
+            const size_t lastRow = min(rows, firstRow + rowsPerBand);
+            pending.push_back(pool->submit([&body, firstRow, lastRow]() { body(firstRow, lastRow); }));
+        }
+        ThreadPool::waitAll(pending);
+    }
+}
+
+// Every vector variant performs the same IEEE operation per element as the
+// functor, so all levels give identical results:
+// - max(x, y) instructions return y when x and y compare equal or either is
+//   NaN, exactly like MaxOp;
+// - SafeDivideOp keeps the quotient where y != 0 (unordered compare, so a NaN
+//   divisor keeps its NaN quotient) and +0 elsewhere, without a branch.
+#if LAB_X86
+namespace {
+    template<typename Op>
+    void rowTail(const double* a, const double* b, double* result, size_t count) {
+        const Op op;
+        for (size_t j = 0; j < count; ++j) {
+            result[j] = op(a[j], b[j]);
+        }
+    }
+
+    template<typename Op>
+    __m128d applySse2(__m128d x, __m128d y) {
+        if constexpr (is_same_v<Op, AddOp>) {
+            return _mm_add_pd(x, y);
+        }
+        else if constexpr (is_same_v<Op, SubtractOp>) {
+            return _mm_sub_pd(x, y);
+        }
+        else if constexpr (is_same_v<Op, MultiplyOp>) {
+            return _mm_mul_pd(x, y);
+        }
+        else if constexpr (is_same_v<Op, SafeDivideOp>) {
+            const __m128d nonzero = _mm_cmpneq_pd(y, _mm_setzero_pd());
+            return _mm_and_pd(nonzero, _mm_div_pd(x, y));
+        }
+        else {
+            return _mm_max_pd(x, y);
+        }
+    }
+
+    template<typename Op>
+    void rowSse2(const double* a, const double* b, double* result, size_t count) {
+        size_t j = 0;
+        for (; j + 4 <= count; j += 4) {
+            const __m128d low = applySse2<Op>(_mm_loadu_pd(a + j), _mm_loadu_pd(b + j));
+            const __m128d high = applySse2<Op>(_mm_loadu_pd(a + j + 2), _mm_loadu_pd(b + j + 2));
+            _mm_storeu_pd(result + j, low);
+            _mm_storeu_pd(result + j + 2, high);
+        }
+        rowTail<Op>(a + j, b + j, result + j, count - j);
+    }
+
+    template<typename Op>
+    LAB_TARGET("avx2")
+    __m256d applyAvx2(__m256d x, __m256d y) {
+        if constexpr (is_same_v<Op, AddOp>) {
+            return _mm256_add_pd(x, y);
+        }
+        else if constexpr (is_same_v<Op, SubtractOp>) {
+            return _mm256_sub_pd(x, y);
+        }
+        else if constexpr (is_same_v<Op, MultiplyOp>) {
+            return _mm256_mul_pd(x, y);
+        }
+        else if constexpr (is_same_v<Op, SafeDivideOp>) {
+            const __m256d nonzero = _mm256_cmp_pd(y, _mm256_setzero_pd(), _CMP_NEQ_UQ);
+            return _mm256_and_pd(nonzero, _mm256_div_pd(x, y));
+        }
+        else {
+            return _mm256_max_pd(x, y);
+        }
+    }
+
+    template<typename Op>
+    LAB_TARGET("avx2")
+    void rowAvx2(const double* a, const double* b, double* result, size_t count) {
+        size_t j = 0;
+        for (; j + 8 <= count; j += 8) {
+            const __m256d low = applyAvx2<Op>(_mm256_loadu_pd(a + j), _mm256_loadu_pd(b + j));
+            const __m256d high = applyAvx2<Op>(_mm256_loadu_pd(a + j + 4), _mm256_loadu_pd(b + j + 4));
+            _mm256_storeu_pd(result + j, low);
+            _mm256_storeu_pd(result + j + 4, high);
+        }
+        if (j + 4 <= count) {
+            _mm256_storeu_pd(result + j, applyAvx2<Op>(_mm256_loadu_pd(a + j), _mm256_loadu_pd(b + j)));
+            j += 4;
+        }
+        rowTail<Op>(a + j, b + j, result + j, count - j);
+    }
+
+    /**
+     * @brief Masked lanes of the result are 0 and raise no FP exception.
+     */
+    template<typename Op>
+    LAB_TARGET("avx512f")
+    __m512d applyAvx512(__mmask8 lanes, __m512d x, __m512d y) {
+        if constexpr (is_same_v<Op, AddOp>) {
+            return _mm512_maskz_add_pd(lanes, x, y);
+        }
+        else if constexpr (is_same_v<Op, SubtractOp>) {
+            return _mm512_maskz_sub_pd(lanes, x, y);
+        }
+        else if constexpr (is_same_v<Op, MultiplyOp>) {
+            return _mm512_maskz_mul_pd(lanes, x, y);
+        }
+        else if constexpr (is_same_v<Op, SafeDivideOp>) {
+            const __mmask8 nonzero = _mm512_mask_cmp_pd_mask(lanes, y, _mm512_setzero_pd(), _CMP_NEQ_UQ);
+            return _mm512_maskz_div_pd(nonzero, x, y);
+        }
+        else {
+            return _mm512_maskz_max_pd(lanes, x, y);
+        }
+    }
+
+    /**
+     * @brief The tail of the row runs as one masked vector instead of a scalar loop.
+     */
+    template<typename Op>
+    LAB_TARGET("avx512f")
+    void rowAvx512(const double* a, const double* b, double* result, size_t count) {
+        const __mmask8 all = 0xFF;
+        size_t j = 0;
+        for (; j + 8 <= count; j += 8) {
+            const __m512d x = _mm512_loadu_pd(a + j);
+            const __m512d y = _mm512_loadu_pd(b + j);
+            _mm512_storeu_pd(result + j, applyAvx512<Op>(all, x, y));
+        }
+        if (j < count) {
+            const __mmask8 tail = static_cast<__mmask8>((1u << (count - j)) - 1);
+            const __m512d x = _mm512_maskz_loadu_pd(tail, a + j);
+            const __m512d y = _mm512_maskz_loadu_pd(tail, b + j);
+            _mm512_mask_storeu_pd(result + j, tail, applyAvx512<Op>(tail, x, y));
+        }
+    }
+}
+#endif
+
+namespace {
+    /**
+     * @brief SafeDivideOp or MaxOp, spelled out: GCC does not inline a function
+     * compiled with other FP options, such as the functors, into compareRow().
+     */
+    template<typename Op>
+    LAB_NO_TRAPPING_MATH
+    double compareElement(double x, double y) {
+        if constexpr (is_same_v<Op, SafeDivideOp>) {
+            const double quotient = x / y;
+            return (y != 0.0) ? quotient : 0.0;
+        }
+        else {
+            return (x > y) ? x : y;
+        }
+    }
+
+    /**
+     * @brief transformRow() of SafeDivideOp or MaxOp. GCC vectorizes the select
+     * only where it may assume that no FP exception traps.
+     */
+    template<typename Op>
+    LAB_NO_TRAPPING_MATH
+    void compareRow(const double* LAB_RESTRICT a, const double* LAB_RESTRICT b,
+        double* LAB_RESTRICT result, size_t count) {
+        size_t j = 0;
+        for (; j + MATRIX_ROW_QUANTUM <= count; j += MATRIX_ROW_QUANTUM) {
+            for (size_t k = 0; k < MATRIX_ROW_QUANTUM; ++k) {
+                result[j + k] = compareElement<Op>(a[j + k], b[j + k]);
+            }
+        }
+        for (; j < count; ++j) {
+            result[j] = compareElement<Op>(a[j], b[j]);
+        }
+    }
+
+    /**
+     * @brief Row kernel of the operations with a compare at SimdLevel::SCALAR.
+     */
+    template<typename Op>
+    void rowScalarCompare(const double* a, const double* b, double* result, size_t count) {
+        if (result == a || result == b) {
+            elementwise_detail::transformRowInPlace(a, b, result, count, Op());
+        }
+        else {
+            compareRow<Op>(a, b, result, count);
+        }
+    }
+
+    template<typename Op>
+    elementwise_detail::RowKernel selectRowKernel() {
+#if LAB_X86
+        switch (simdLevel()) {
+        case SimdLevel::AVX512:
+            return rowAvx512<Op>;
+        case SimdLevel::AVX2:
+            return rowAvx2<Op>;
+        case SimdLevel::SSE2:
+            return rowSse2<Op>;
+        default:
+            break;
+        }
+#endif
+        return nullptr;
+    }
+}
+
+namespace elementwise_detail {
+    RowKernel simdRowKernel(const AddOp&) {
+        return selectRowKernel<AddOp>();
+    }
+
+    RowKernel simdRowKernel(const SubtractOp&) {
+        return selectRowKernel<SubtractOp>();
+    }
+
+    RowKernel simdRowKernel(const MultiplyOp&) {
+        return selectRowKernel<MultiplyOp>();
+    }
+
+    RowKernel simdRowKernel(const SafeDivideOp&) {
+        const RowKernel kernel = selectRowKernel<SafeDivideOp>();
+        return (kernel != nullptr) ? kernel : rowScalarCompare<SafeDivideOp>;
+    }
+
+    RowKernel simdRowKernel(const MaxOp&) {
+        const RowKernel kernel = selectRowKernel<MaxOp>();
+        return (kernel != nullptr) ? kernel : rowScalarCompare<MaxOp>;
+    }
+}
+
+// The range kernels fold elements with min(x, acc) and max(x, acc), which
+// return the accumulator acc when x is NaN, so NaN is skipped at every level.
+namespace {
+    /**
+     * @brief Range of rows [firstRow, lastRow) of a matrix.
+     */
+    using RangeKernel = ElementRange (*)(ConstMatrixView matrix, size_t firstRow, size_t lastRow);
+
+    void foldScalar(const double* values, size_t count, ElementRange& range) {
+        for (size_t j = 0; j < count; ++j) {
+            range.min = (values[j] < range.min) ? values[j] : range.min;
+            range.max = (values[j] > range.max) ? values[j] : range.max;
+        }
+    }
+
+    ElementRange rangeScalar(ConstMatrixView matrix, size_t firstRow, size_t lastRow) {
+        ElementRange range{ numeric_limits<double>::infinity(), -numeric_limits<double>::infinity() };
+        for (size_t i = firstRow; i < lastRow; ++i) {
+            foldScalar(matrix[i], matrix.cols(), range);
+        }
+        return range;
+    }
+
+    /**
+     * @brief Combines the lanes of the vector accumulators (stored to low and high) into range.
+     */
+    void foldLanes(const double* low, const double* high, size_t lanes, ElementRange& range) {
+        for (size_t k = 0; k < lanes; ++k) {
+            range.min = min(range.min, low[k]);
+            range.max = max(range.max, high[k]);
+        }
+    }
+
+#if LAB_X86
+    ElementRange rangeSse2(ConstMatrixView matrix, size_t firstRow, size_t lastRow) {
+        ElementRange range{ numeric_limits<double>::infinity(), -numeric_limits<double>::infinity() };
+        __m128d low0 = _mm_set1_pd(range.min);
+        __m128d low1 = low0;
+        __m128d high0 = _mm_set1_pd(range.max);
+        __m128d high1 = high0;
+
+        const size_t cols = matrix.cols();
+        for (size_t i = firstRow; i < lastRow; ++i) {
+            const double* row = matrix[i];
+            size_t j = 0;
+            for (; j + 4 <= cols; j += 4) {
+                const __m128d x0 = _mm_loadu_pd(row + j);
+                const __m128d x1 = _mm_loadu_pd(row + j + 2);
+                low0 = _mm_min_pd(x0, low0);
+                low1 = _mm_min_pd(x1, low1);
+                high0 = _mm_max_pd(x0, high0);
+                high1 = _mm_max_pd(x1, high1);
+            }
+            foldScalar(row + j, cols - j, range);
+        }
+
+        double low[2];
+        double high[2];
+        _mm_storeu_pd(low, _mm_min_pd(low0, low1));
+        _mm_storeu_pd(high, _mm_max_pd(high0, high1));
+        foldLanes(low, high, 2, range);
+        return range;
+    }
+
+    LAB_TARGET("avx2")
+    ElementRange rangeAvx2(ConstMatrixView matrix, size_t firstRow, size_t lastRow) {
+        ElementRange range{ numeric_limits<double>::infinity(), -numeric_limits<double>::infinity() };
+        __m256d low0 = _mm256_set1_pd(range.min);
+        __m256d low1 = low0;
+        __m256d high0 = _mm256_set1_pd(range.max);
+        __m256d high1 = high0;
+
+        const size_t cols = matrix.cols();
+        for (size_t i = firstRow; i < lastRow; ++i) {
+            const double* row = matrix[i];
+            size_t j = 0;
+            for (; j + 8 <= cols; j += 8) {
+                const __m256d x0 = _mm256_loadu_pd(row + j);
+                const __m256d x1 = _mm256_loadu_pd(row + j + 4);
+                low0 = _mm256_min_pd(x0, low0);
+                low1 = _mm256_min_pd(x1, low1);
+                high0 = _mm256_max_pd(x0, high0);
+                high1 = _mm256_max_pd(x1, high1);
+            }
+            foldScalar(row + j, cols - j, range);
+        }
+
+        double low[4];
+        double high[4];
+        _mm256_storeu_pd(low, _mm256_min_pd(low0, low1));
+        _mm256_storeu_pd(high, _mm256_max_pd(high0, high1));
+        foldLanes(low, high, 4, range);
+        return range;
+    }
+
+    /**
+     * @brief Row tails are folded as one masked vector; masked-off lanes keep the accumulator.
+     * Full vectors use the masked forms too, with every lane set: GCC 12 reports
+     * the unmasked min/max as reading an uninitialized value.
+     */
+    LAB_TARGET("avx512f")
+    ElementRange rangeAvx512(ConstMatrixView matrix, size_t firstRow, size_t lastRow) {
+        const __mmask8 all = 0xFF;
+        ElementRange range{ numeric_limits<double>::infinity(), -numeric_limits<double>::infinity() };
+        __m512d low0 = _mm512_set1_pd(range.min);
+        __m512d low1 = low0;
+        __m512d high0 = _mm512_set1_pd(range.max);
+        __m512d high1 = high0;
+
+        const size_t cols = matrix.cols();
+        for (size_t i = firstRow; i < lastRow; ++i) {
+            const double* row = matrix[i];
+            size_t j = 0;
+            for (; j + 16 <= cols; j += 16) {
+                const __m512d x0 = _mm512_loadu_pd(row + j);
+                const __m512d x1 = _mm512_loadu_pd(row + j + 8);
+                low0 = _mm512_mask_min_pd(low0, all, x0, low0);
+                low1 = _mm512_mask_min_pd(low1, all, x1, low1);
+                high0 = _mm512_mask_max_pd(high0, all, x0, high0);
+                high1 = _mm512_mask_max_pd(high1, all, x1, high1);
+            }
+            for (; j < cols; j += 8) {
+                const __mmask8 lanes = (cols - j >= 8) ? all : static_cast<__mmask8>((1u << (cols - j)) - 1);
+                const __m512d x = _mm512_maskz_loadu_pd(lanes, row + j);
+                low0 = _mm512_mask_min_pd(low0, lanes, x, low0);
+                high0 = _mm512_mask_max_pd(high0, lanes, x, high0);
+            }
+        }
+
+        double low[8];
+        double high[8];
+        _mm512_storeu_pd(low, _mm512_mask_min_pd(low0, all, low0, low1));
+        _mm512_storeu_pd(high, _mm512_mask_max_pd(high0, all, high0, high1));
+        foldLanes(low, high, 8, range);
+        return range;
+    }
+#endif
+
+    RangeKernel rangeKernel() {
+#if LAB_X86
+        switch (simdLevel()) {
+        case SimdLevel::AVX512:
+            return rangeAvx512;
+        case SimdLevel::AVX2:
+            return rangeAvx2;
+        case SimdLevel::SSE2:
+            return rangeSse2;
+        default:
+            break;
+        }
+#endif
+        return rangeScalar;
+    }
+
+    ElementRange rangeOnBands(ThreadPool* pool, ConstMatrixView matrix) {
+        const RangeKernel kernel = rangeKernel();
+        ElementRange range{ numeric_limits<double>::infinity(), -numeric_limits<double>::infinity() };
+        mutex rangeMutex;
+        elementwise_detail::forEachRowBand(pool, matrix.rows(), matrix.cols(), [&](size_t firstRow, size_t lastRow) {
+            const ElementRange band = kernel(matrix, firstRow, lastRow);
+            lock_guard<mutex> lock(rangeMutex);
+            range.min = min(range.min, band.min);
+            range.max = max(range.max, band.max);
+        });
+        return range;
+    }
+}
+
+ElementRange elementRange(ConstMatrixView matrix) {
+    return rangeOnBands(&sharedThreadPool(), matrix);
+}
+
+ElementRange elementRange(ThreadPool& pool, ConstMatrixView matrix) {
+    return rangeOnBands(&pool, matrix);
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+
+#include "cpu_features.h"
+#include "dynamic_matrix.h"
+#include "thread_pool.h"
+
+// ============================================================================
+// OPERATIONS
+// ============================================================================
+
+struct AddOp {
+    double operator()(double x, double y) const {
+        return x + y;
+    }
+};
+
+struct SubtractOp {
+    double operator()(double x, double y) const {
+        return x - y;
+    }
+};
+
+struct MultiplyOp {
+    double operator()(double x, double y) const {
+        return x * y;
+    }
+};
+
+/**
+ * @brief x / y, or 0 where y is 0.
+ * The quotient is computed unconditionally and then selected, so the
+ * operation has no branch and vectorizes (x / 0 is discarded).
+ */
+struct SafeDivideOp {
+    double operator()(double x, double y) const {
+        const double quotient = x / y;
+        return (y != 0.0) ? quotient : 0.0;
+    }
+};
+
+/**
+ * @brief Larger of x and y; y if they compare equal or either is NaN (like maxpd).
+ */
+struct MaxOp {
+    double operator()(double x, double y) const {
+        return (x > y) ? x : y;
+    }
+};
+
+// ============================================================================
+// ENGINE
+// ============================================================================
+
+// Least elements in a band of rows that runs as its own pool task (256 KiB of
+// each operand, tens of microseconds of work, well above the cost of a task).
+// A matrix smaller than two bands, such as the 4x3 of task 3, stays on the calling thread.
+constexpr std::size_t PARALLEL_GRAIN_ELEMENTS = std::size_t(1) << 15;
+
+namespace elementwise_detail {
+    /**
+     * @brief Work on the rows [firstRow, lastRow) of a matrix.
+     */
+    using RowBandBody = std::function<void(std::size_t firstRow, std::size_t lastRow)>;
+
+    /**
+     * @brief Calls body on consecutive bands of rows covering [0, rows) of a rows x cols matrix.
+     * Bands of at least PARALLEL_GRAIN_ELEMENTS elements run as tasks on pool;
+     * when there is no pool, a pool of one worker or only one band,
+     * body(0, rows) runs on the calling thread.
+     * @param pool Pool to run on, or nullptr
+     */
+    void forEachRowBand(ThreadPool* pool, std::size_t rows, std::size_t cols, const RowBandBody& body);
+
+    /**
+     * @brief result[j] = op(a[j], b[j]) for rows that do not overlap.
+     * Groups of MATRIX_ROW_QUANTUM elements have a constant trip count, which
+     * compilers vectorize without a runtime remainder check.
+     */
+    template<typename Op>
+    void transformRow(const double* LAB_RESTRICT a, const double* LAB_RESTRICT b,
+        double* LAB_RESTRICT result, std::size_t count, const Op& op) {
+        std::size_t j = 0;
+        for (; j + MATRIX_ROW_QUANTUM <= count; j += MATRIX_ROW_QUANTUM) {
+            for (std::size_t k = 0; k < MATRIX_ROW_QUANTUM; ++k) {
+                result[j + k] = op(a[j + k], b[j + k]);
+            }
+        }
+        for (; j < count; ++j) {
+            result[j] = op(a[j], b[j]);
+        }
+    }
+
+    /**
+     * @brief Same as transformRow() when result is a or b itself.
+     */
+    template<typename Op>
+    void transformRowInPlace(const double* a, const double* b, double* result, std::size_t count, const Op& op) {
+        for (std::size_t j = 0; j < count; ++j) {
+            result[j] = op(a[j], b[j]);
+        }
+    }
+
+    /**
+     * @brief Hand-written row kernel: result[j] = op(a[j], b[j]) for j < count.
+     * result may be a or b itself; every vector is loaded before it is stored.
+     */
+    using RowKernel = void (*)(const double* a, const double* b, double* result, std::size_t count);
+
+    /**
+     * @brief SIMD row kernel of op for simdLevel(), or nullptr to run the inlined loop.
+     * Other operations have no kernel; the built-in ones are overloaded below.
+     */
+    template<typename Op>
+    RowKernel simdRowKernel(const Op&) {
+        return nullptr;
+    }
+
+    // AVX-512, AVX2 and SSE2 kernels in elementwise.cpp, bit-identical to the
+    // operations above; at SimdLevel::SCALAR nullptr, or a portable loop for
+    // the operations with a compare
+    RowKernel simdRowKernel(const AddOp&);
+    RowKernel simdRowKernel(const SubtractOp&);
+    RowKernel simdRowKernel(const MultiplyOp&);
+    RowKernel simdRowKernel(const SafeDivideOp&);
+    RowKernel simdRowKernel(const MaxOp&);
+}
+
+namespace elementwise_detail {
+    /**
+     * @brief transformElements() on bands of rows distributed by forEachRowBand().
+     */
+    template<typename Op>
+    void transformBands(ThreadPool* pool, ConstMatrixView a, ConstMatrixView b, MatrixView result, const Op& op) {
+        if (!a.sameShape(b) || !a.sameShape(result)) {
+            throw std::invalid_argument("Matrix dimensions do not match");
+        }
+
+        const RowKernel kernel = simdRowKernel(op);
+        forEachRowBand(pool, a.rows(), a.cols(), [&](std::size_t firstRow, std::size_t lastRow) {
+            for (std::size_t i = firstRow; i < lastRow; ++i) {
+                const double* rowA = a[i];
+                const double* rowB = b[i];
+                double* rowResult = result[i];
+                if (kernel != nullptr) {
+                    kernel(rowA, rowB, rowResult, a.cols());
+                }
+                else if (rowResult == rowA || rowResult == rowB) {
+                    transformRowInPlace(rowA, rowB, rowResult, a.cols(), op);
+                }
+                else {
+                    transformRow(rowA, rowB, rowResult, a.cols(), op);
+                }
+            }
+        });
+    }
+}
+
+/**
+ * @brief result(i, j) = op(a(i, j), b(i, j)) for every element.
+ * Op is any callable double(double, double) and is inlined into the row loop,
+ * unlike a std::function, which costs an indirect call per element and keeps
+ * the loop scalar. The built-in operations instead run the SIMD row kernel
+ * chosen once per call from simdLevel(). Matrices of at least two grains
+ * (PARALLEL_GRAIN_ELEMENTS) are split into bands of rows on sharedThreadPool(),
+ * so op must be safe to call concurrently. result may be a or b itself but
+ * must not partially overlap them.
+ * @throws invalid_argument if the three views differ in shape
+ */
+template<typename Op>
+void transformElements(ConstMatrixView a, ConstMatrixView b, MatrixView result, Op op) {
+    elementwise_detail::transformBands(&sharedThreadPool(), a, b, result, op);
+}
+
+/**
+ * @brief Same as transformElements(a, b, result, op), with the bands on pool.
+ * @param pool Pool to run on
+ */
+template<typename Op>
+void transformElements(ThreadPool& pool, ConstMatrixView a, ConstMatrixView b, MatrixView result, Op op) {
+    elementwise_detail::transformBands(&pool, a, b, result, op);
+}
+
+// Pre-instantiated in elementwise.cpp; other files call these instead of instantiating
+extern template void elementwise_detail::transformBands<AddOp>(ThreadPool*, ConstMatrixView, ConstMatrixView, MatrixView, const AddOp&);
+extern template void elementwise_detail::transformBands<SubtractOp>(ThreadPool*, ConstMatrixView, ConstMatrixView, MatrixView, const SubtractOp&);
+extern template void elementwise_detail::transformBands<MultiplyOp>(ThreadPool*, ConstMatrixView, ConstMatrixView, MatrixView, const MultiplyOp&);
+extern template void elementwise_detail::transformBands<SafeDivideOp>(ThreadPool*, ConstMatrixView, ConstMatrixView, MatrixView, const SafeDivideOp&);
+extern template void elementwise_detail::transformBands<MaxOp>(ThreadPool*, ConstMatrixView, ConstMatrixView, MatrixView, const MaxOp&);
+
+// ============================================================================
+// REDUCTIONS
+// ============================================================================
+
+/**
+ * @brief Smallest and largest element of a matrix.
+ */
+struct ElementRange {
+    double min;
+    double max;
+};
+
+/**
+ * @brief Smallest and largest element, skipping NaN.
+ * Bands of rows are reduced in parallel like transformElements() and then
+ * combined. Between elements that compare equal, such as -0.0 and 0.0,
+ * either may be returned.
+ * @return {+inf, -inf} for an empty matrix or one of only NaN
+ */
+ElementRange elementRange(ConstMatrixView matrix);
+
+/**
+ * @brief Same as elementRange(matrix), with the bands on pool.
+ * @param pool Pool to run on
+ */
+ElementRange elementRange(ThreadPool& pool, ConstMatrixView matrix);
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+
+/**
+ * @brief Fixed-point field: same bytes as `setw(width) << fixed << setprecision(precision)`.
+ */
+struct FixedField {
+    double value;
+    int width;
+    int precision;
+};
+
+/**
+ * @brief Integer field: same bytes as `setw(width) << value`.
+ */
+struct IntField {
+    long long value;
+    int width;
+};
+
+/**
+ * @brief Default-notation field: same bytes as `setw(width) << setprecision(precision) << value`
+ * on a stream without fixed/scientific flags (printf "%g").
+ */
+struct GeneralField {
+    double value;
+    int width;
+    int precision;
+};
+
+inline FixedField fixedField(double value, int width, int precision) {
+    return { value, width, precision };
+}
+
+inline IntField intField(long long value, int width = 0) {
+    return { value, width };
+}
+
+inline GeneralField generalField(double value, int width = 0, int precision = 6) {
+    return { value, width, precision };
+}
+
+namespace fast_format {
+
+    /// Longest fixed-notation double before the decimal point, plus sign and point
+    constexpr std::size_t MAX_FIXED_INTEGER_CHARS = 312;
+    /// Longest "%g" output for precision <= 17 ("-1.2345678901234567e-308")
+    constexpr std::size_t MAX_GENERAL_CHARS = 32;
+    /// Longest long long including sign
+    constexpr std::size_t MAX_INT_CHARS = 20;
+
+    /**
+     * @brief Right-aligns the text in [out, end) inside a field of the given width.
+     * Characters are shifted right and the gap is filled with spaces, as setw does.
+     * @return End of the padded field
+     */
+    inline char* padLeft(char* out, char* end, int width) {
+        std::size_t length = static_cast<std::size_t>(end - out);
+        if (width <= 0 || length >= static_cast<std::size_t>(width)) {
+            return end;
+        }
+        std::size_t gap = static_cast<std::size_t>(width) - length;
+        std::memmove(out + gap, out, length);
+        std::memset(out, ' ', gap);
+        return out + width;
+    }
+
+    /**
+     * @brief Upper bound of bytes formatField() writes for a field.
+     */
+    inline std::size_t maxSize(const FixedField& field) {
+        return std::max<std::size_t>(field.width, MAX_FIXED_INTEGER_CHARS + field.precision);
+    }
+
+    inline std::size_t maxSize(const IntField& field) {
+        return std::max<std::size_t>(field.width, MAX_INT_CHARS);
+    }
+
+    inline std::size_t maxSize(const GeneralField& field) {
+        return std::max<std::size_t>(field.width, MAX_GENERAL_CHARS + field.precision);
+    }
+
+    /**
+     * @brief Formats a field into out, which must hold at least maxSize(field) bytes.
+     * @return Pointer past the last written byte
+     */
+    inline char* formatField(char* out, const FixedField& field) {
+        auto result = std::to_chars(out, out + maxSize(field), field.value,
+            std::chars_format::fixed, field.precision);
+        return padLeft(out, result.ptr, field.width);
+    }
+
+    inline char* formatField(char* out, const IntField& field) {
+        auto result = std::to_chars(out, out + maxSize(field), field.value);
+        return padLeft(out, result.ptr, field.width);
+    }
+
+    /**
+     * @brief Returns true if product is exactly a * b (no rounding happened).
+     */
+    inline bool isExactProduct(double a, double b, double product) {
+#ifdef FP_FAST_FMA
+        return std::fma(a, b, -product) == 0.0;
+#else
+        // Dekker's error-free product; valid because nothing here is contracted to FMA
+        constexpr double SPLIT = 134217729.0;  // 2^27 + 1
+        const double ca = SPLIT * a;
+        const double aHigh = ca - (ca - a);
+        const double aLow = a - aHigh;
+        const double cb = SPLIT * b;
+        const double bHigh = cb - (cb - b);
+        const double bLow = b - bHigh;
+        return ((aHigh * bHigh - product) + aHigh * bLow + aLow * bHigh) + aLow * bLow == 0.0;
+#endif
+    }
+
+    /// Largest precision formatGeneralShort() handles
+    constexpr int MAX_SHORT_PRECISION = 7;
+
+    /**
+     * @brief "%.{precision}g" for short precisions without to_chars.
+     * Scales the value by one exact power of ten so that the significant digits
+     * form an integer, then lays the digits out as printf does. The scaling
+     * rounds once, far below the 1e-7 margin checked around the rounding
+     * point; exact ties round to even. Inexact near-ties, zero, subnormals,
+     * huge exponents and non-finite values are refused.
+     * @return End of the text, or nullptr if the caller must use to_chars
+     */
+    inline char* formatGeneralShort(char* out, double value, int precision) {
+        static constexpr double POW10[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        if (precision > MAX_SHORT_PRECISION || value == 0.0 || !std::isfinite(value)) {
+            return nullptr;
+        }
+
+        const double magnitude = std::fabs(value);
+
+        // Decimal exponent estimated from the binary one (exact or one too small)
+        std::uint64_t bits;
+        std::memcpy(&bits, &magnitude, sizeof(bits));
+        const int binaryExponent = static_cast<int>(bits >> 52) - 1023;
+        if (binaryExponent < -1022) {
+            return nullptr;  // Subnormal
+        }
+        int exponent = static_cast<int>(std::floor(binaryExponent * 0.30102999566398120));
+        int shift = 0;
+        double scaled = 0.0;
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            shift = precision - 1 - exponent;
+            if (shift < -22 || shift > 22) {
+                return nullptr;
+            }
+            scaled = (shift >= 0) ? magnitude * POW10[shift] : magnitude / POW10[-shift];
+
+            if (scaled >= POW10[precision]) {
+                ++exponent;
+            }
+            else if (scaled < POW10[precision - 1]) {
+                --exponent;
+            }
+            else {
+                break;
+            }
+        }
+        if (scaled >= POW10[precision] || scaled < POW10[precision - 1]) {
+            return nullptr;
+        }
+
+        std::uint64_t digits = static_cast<std::uint64_t>(scaled);
+        const double fraction = scaled - static_cast<double>(digits);
+        if (std::fabs(fraction - 0.5) < 1e-7) {
+            // Too close to call unless the scaling was exact (e.g. 75003.25 at precision 6)
+            if (shift < 0 || !isExactProduct(magnitude, POW10[shift], scaled)) {
+                return nullptr;
+            }
+            digits += (fraction > 0.5 || (fraction == 0.5 && (digits & 1) != 0)) ? 1 : 0;  // Ties to even
+        }
+        else {
+            digits += (fraction > 0.5) ? 1 : 0;
+        }
+        if (digits == static_cast<std::uint64_t>(POW10[precision])) {
+            digits /= 10;
+            ++exponent;
+        }
+
+        // Significant digits without trailing zeros
+        char text[MAX_SHORT_PRECISION];
+        for (int i = precision - 1; i >= 0; --i) {
+            text[i] = static_cast<char>('0' + digits % 10);
+            digits /= 10;
+        }
+        int length = precision;
+        while (length > 1 && text[length - 1] == '0') {
+            --length;
+        }
+
+        if (value < 0) {
+            *out++ = '-';
+        }
+
+        if (exponent < -4 || exponent >= precision) {
+            *out++ = text[0];
+            if (length > 1) {
+                *out++ = '.';
+                std::memcpy(out, text + 1, static_cast<std::size_t>(length - 1));
+                out += length - 1;
+            }
+            *out++ = 'e';
+            *out++ = (exponent < 0) ? '-' : '+';
+            int shown = (exponent < 0) ? -exponent : exponent;
+            if (shown >= 100) {
+                *out++ = static_cast<char>('0' + shown / 100);
+                shown %= 100;
+            }
+            *out++ = static_cast<char>('0' + shown / 10);
+            *out++ = static_cast<char>('0' + shown % 10);
+        }
+        else if (exponent >= 0) {
+            const int integerDigits = exponent + 1;
+            for (int i = 0; i < integerDigits; ++i) {
+                *out++ = (i < length) ? text[i] : '0';
+            }
+            if (length > integerDigits) {
+                *out++ = '.';
+                std::memcpy(out, text + integerDigits, static_cast<std::size_t>(length - integerDigits));
+                out += length - integerDigits;
+            }
+        }
+        else {
+            *out++ = '0';
+            *out++ = '.';
+            for (int i = 0; i < -exponent - 1; ++i) {
+                *out++ = '0';
+            }
+            std::memcpy(out, text, static_cast<std::size_t>(length));
+            out += length;
+        }
+        return out;
+    }
+
+    inline char* formatField(char* out, const GeneralField& field) {
+        // iostream treats precision 0 as 1 in default notation, like printf
+        int precision = (field.precision == 0) ? 1 : field.precision;
+        char* end = formatGeneralShort(out, field.value, precision);
+        if (end == nullptr) {
+            end = std::to_chars(out, out + maxSize(field), field.value,
+                std::chars_format::general, precision).ptr;
+        }
+        return padLeft(out, end, field.width);
+    }
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief Lazy sequence produced by a coroutine that co_yields values
+ * (the subset of C++23 std::generator the tasks need).
+ * Nothing runs until the first value is requested and each increment resumes
+ * the coroutine up to its next co_yield. Destroying the generator destroys
+ * the suspended coroutine, so no value past the consumer's stop point is
+ * ever computed and nothing is buffered. Move-only; iterate once.
+ *
+ * Exceptions thrown inside the coroutine reach the consumer from begin() or
+ * operator++.
+ */
+template<typename T>
+class Generator {
+public:
+    struct promise_type {
+        const T* current = nullptr;     ///< Operand of the last co_yield, alive while suspended
+        std::exception_ptr error;
+
+        Generator get_return_object() noexcept {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always yield_value(const T& value) noexcept {
+            current = std::addressof(value);
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept {
+            error = std::current_exception();
+        }
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    /**
+     * @brief Input iterator over the yielded values; compares equal to end() when done.
+     */
+    class iterator {
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        explicit iterator(Handle coroutine) : coroutine_(coroutine) {}
+
+        const T& operator*() const {
+            return *coroutine_.promise().current;
+        }
+
+        iterator& operator++() {
+            resume(coroutine_);
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        bool operator==(std::default_sentinel_t) const {
+            return !coroutine_ || coroutine_.done();
+        }
+
+    private:
+        Handle coroutine_;
+    };
+
+    Generator(Generator&& other) noexcept
+        : coroutine_(std::exchange(other.coroutine_, {})) {
+    }
+
+    Generator& operator=(Generator&& other) noexcept {
+        if (this != &other) {
+            if (coroutine_) {
+                coroutine_.destroy();
+            }
+            coroutine_ = std::exchange(other.coroutine_, {});
+        }
+        return *this;
+    }
+
+    ~Generator() {
+        if (coroutine_) {
+            coroutine_.destroy();
+        }
+    }
+
+    /**
+     * @brief Runs the coroutine up to its first co_yield.
+     */
+    iterator begin() {
+        if (coroutine_) {
+            resume(coroutine_);
+        }
+        return iterator(coroutine_);
+    }
+
+    std::default_sentinel_t end() const noexcept {
+        return {};
+    }
+
+private:
+    explicit Generator(Handle coroutine) : coroutine_(coroutine) {}
+
+    static void resume(Handle coroutine) {
+        coroutine.resume();
+        if (coroutine.done() && coroutine.promise().error) {
+            std::rethrow_exception(coroutine.promise().error);
+        }
+    }
+
+    Handle coroutine_;
+};
+
+// ============================================================================
+// ADAPTERS
+// ============================================================================
+
+/**
+ * @brief Yields the first count values of source and stops without pulling another.
+ */
+template<typename T>
+Generator<T> take(Generator<T> source, long long count) {
+    if (count <= 0) {
+        co_return;
+    }
+    for (const T& value : source) {
+        co_yield value;
+        if (--count == 0) {
+            co_return;
+        }
+    }
+}
+
+/**
+ * @brief Yields values of source while predicate(value) holds.
+ */
+template<typename T, typename Predicate>
+Generator<T> takeWhile(Generator<T> source, Predicate predicate) {
+    for (const T& value : source) {
+        if (!predicate(value)) {
+            co_return;
+        }
+        co_yield value;
+    }
+}
+
+/**
+ * @brief Sampler: yields the first value of source and then every step-th one.
+ */
+template<typename T>
+Generator<T> stride(Generator<T> source, long long step) {
+    long long skip = 0;
+    for (const T& value : source) {
+        if (skip == 0) {
+            co_yield value;
+            skip = (step > 0) ? step : 1;
+        }
+        --skip;
+    }
+}
@@ -0,0 +1,115 @@
+#include "instrumentation.h"
+
+using namespace std;
+
+namespace {
+    constexpr size_t PHASE_COUNT = static_cast<size_t>(Phase::COUNT);
+    constexpr size_t COUNTER_COUNT = static_cast<size_t>(Counter::COUNT);
+
+    atomic<bool> g_enabled{ false };
+    atomic<uint64_t> g_phaseNs[PHASE_COUNT];
+    atomic<uint64_t> g_phaseCalls[PHASE_COUNT];
+    atomic<uint64_t> g_counters[COUNTER_COUNT];
+}
+
+namespace instrumentation {
+    void enable(bool on) {
+        g_enabled.store(on, memory_order_relaxed);
+    }
+
+    bool enabled() {
+        return g_enabled.load(memory_order_relaxed);
+    }
+
+    void reset() {
+        for (size_t i = 0; i < PHASE_COUNT; ++i) {
+            g_phaseNs[i].store(0, memory_order_relaxed);
+            g_phaseCalls[i].store(0, memory_order_relaxed);
+        }
+        for (auto& counter : g_counters) {
+            counter.store(0, memory_order_relaxed);
+        }
+    }
+
+    void addTime(Phase phase, uint64_t ns) {
+        size_t index = static_cast<size_t>(phase);
+        g_phaseNs[index].fetch_add(ns, memory_order_relaxed);
+        g_phaseCalls[index].fetch_add(1, memory_order_relaxed);
+    }
+
+    void add(Counter counter, uint64_t value) {
+        g_counters[static_cast<size_t>(counter)].fetch_add(value, memory_order_relaxed);
+    }
+
+    InstrumentationReport snapshot() {
+        InstrumentationReport report;
+        for (size_t i = 0; i < PHASE_COUNT; ++i) {
+            report.phaseNs[i] = g_phaseNs[i].load(memory_order_relaxed);
+            report.phaseCalls[i] = g_phaseCalls[i].load(memory_order_relaxed);
+        }
+        for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+            report.counters[i] = g_counters[i].load(memory_order_relaxed);
+        }
+        return report;
+    }
+
+    const char* phaseName(Phase phase) {
+        switch (phase) {
+        case Phase::PARSE: return "parse";
+        case Phase::COMPUTE: return "compute";
+        case Phase::FORMAT: return "format";
+        case Phase::WRITE: return "write";
+        default: return "unknown";
+        }
+    }
+
+    const char* counterName(Counter counter) {
+        switch (counter) {
+        case Counter::BYTES_IN: return "bytes_in";
+        case Counter::BYTES_OUT: return "bytes_out";
+        case Counter::RECORDS: return "records";
+        default: return "unknown";
+        }
+    }
+
+    void writeJson(ostream& out, int task, uint64_t wallNs) {
+        InstrumentationReport report = snapshot();
+
+        out << "{\n  \"task\": " << task << ",\n  \"wall_ns\": " << wallNs << ",\n  \"phases\": {";
+        for (size_t i = 0; i < PHASE_COUNT; ++i) {
+            out << (i ? ",\n" : "\n") << "    \"" << phaseName(static_cast<Phase>(i)) << "\": {\"ns\": "
+                << report.phaseNs[i] << ", \"calls\": " << report.phaseCalls[i] << "}";
+        }
+        out << "\n  },\n  \"counters\": {";
+        for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+            out << (i ? ", " : "") << "\"" << counterName(static_cast<Counter>(i)) << "\": "
+                << report.counters[i];
+        }
+        out << "}\n}\n";
+    }
+
+    void writeCsv(ostream& out, int task, uint64_t wallNs, bool header) {
+        InstrumentationReport report = snapshot();
+
+        if (header) {
+            out << "task,wall_ns";
+            for (size_t i = 0; i < PHASE_COUNT; ++i) {
+                const char* name = phaseName(static_cast<Phase>(i));
+                out << "," << name << "_ns," << name << "_calls";
+            }
+            for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+                out << "," << counterName(static_cast<Counter>(i));
+            }
+            out << "\n";
+        }
+
+        out << task << "," << wallNs;
+        for (size_t i = 0; i < PHASE_COUNT; ++i) {
+            out << "," << report.phaseNs[i] << "," << report.phaseCalls[i];
+        }
+        for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+            out << "," << report.counters[i];
+        }
+        out << "\n";
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Set to 0 (e.g. /D LAB_INSTRUMENTATION=0) to compile every timer and counter out.
+#ifndef LAB_INSTRUMENTATION
+#define LAB_INSTRUMENTATION 1
+#endif
+
+/**
+ * @brief Phases of a task run that are timed separately.
+ * WRITE runs on the flush thread of DualOutputWriter and overlaps the others.
+ */
+enum class Phase {
+    PARSE,      ///< Reading and parsing input files
+    COMPUTE,    ///< Task kernels (operations, sorting, searching)
+    FORMAT,     ///< Formatting results into the output buffer
+    WRITE,      ///< Sinks writing buffered bytes to console/file
+    COUNT
+};
+
+/**
+ * @brief Quantities counted during a task run.
+ */
+enum class Counter {
+    BYTES_IN,   ///< Bytes of input files mapped
+    BYTES_OUT,  ///< Bytes handed to output sinks
+    RECORDS,    ///< Records parsed or produced (numbers, matrix elements, students)
+    COUNT
+};
+
+/**
+ * @brief Totals collected since the last reset().
+ */
+struct InstrumentationReport {
+    std::uint64_t phaseNs[static_cast<std::size_t>(Phase::COUNT)] = {};
+    std::uint64_t phaseCalls[static_cast<std::size_t>(Phase::COUNT)] = {};
+    std::uint64_t counters[static_cast<std::size_t>(Counter::COUNT)] = {};
+};
+
+/**
+ * @brief Process-wide phase timers and counters.
+ * Collection is off until enable(true); while off a timer costs one relaxed
+ * load and no clock reads. All updates are relaxed atomics so the flush
+ * thread and the task thread can record concurrently.
+ */
+namespace instrumentation {
+    void enable(bool on);
+    bool enabled();
+
+    /**
+     * @brief Clears all timers and counters.
+     */
+    void reset();
+
+    void addTime(Phase phase, std::uint64_t ns);
+    void add(Counter counter, std::uint64_t value);
+
+    InstrumentationReport snapshot();
+
+    const char* phaseName(Phase phase);
+    const char* counterName(Counter counter);
+
+    /**
+     * @brief Writes one run as a JSON object.
+     * @param out Destination stream
+     * @param task Task number of the run
+     * @param wallNs Wall-clock time of the whole run
+     */
+    void writeJson(std::ostream& out, int task, std::uint64_t wallNs);
+
+    /**
+     * @brief Writes one run as a CSV row, preceded by the header if requested.
+     */
+    void writeCsv(std::ostream& out, int task, std::uint64_t wallNs, bool header);
+
+    /**
+     * @brief Adds the lifetime of the object to a phase (RAII pattern).
+     */
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Phase phase) : phase_(phase), active_(enabled()) {
+            if (active_) {
+                start_ = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~ScopedTimer() {
+            if (active_) {
+                auto elapsed = std::chrono::steady_clock::now() - start_;
+                addTime(phase_, static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            }
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Phase phase_;
+        bool active_;
+        std::chrono::steady_clock::time_point start_;
+    };
+}
+
+#define LAB_CONCAT_IMPL(a, b) a##b
+#define LAB_CONCAT(a, b) LAB_CONCAT_IMPL(a, b)
+
+#if LAB_INSTRUMENTATION
+/// Times the rest of the enclosing scope as the given Phase
+#define LAB_PHASE(phase) ::instrumentation::ScopedTimer LAB_CONCAT(labPhaseTimer_, __LINE__)(phase)
+/// Adds a value to the given Counter
+#define LAB_COUNT(counter, value) \
+    do { if (::instrumentation::enabled()) ::instrumentation::add(counter, static_cast<std::uint64_t>(value)); } while (0)
+#else
+#define LAB_PHASE(phase) ((void)0)
+#define LAB_COUNT(counter, value) ((void)0)
+#endif
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+// Terms computed from one window of preceding terms by fill()
+constexpr std::size_t RECURRENCE_FILL_LANES = 8;
+
+// Indices below this are reached by stepping; larger ones by a logarithmic jump
+constexpr long long RECURRENCE_JUMP_MIN = 64;
+
+namespace recurrence_detail {
+    // Integer arithmetic wraps around like unsigned instead of being undefined on overflow
+
+    template<typename T>
+    constexpr T add(T a, T b) {
+        if constexpr (std::is_integral_v<T>) {
+            using U = std::make_unsigned_t<T>;
+            return static_cast<T>(static_cast<U>(a) + static_cast<U>(b));
+        }
+        else {
+            return a + b;
+        }
+    }
+
+    template<typename T>
+    constexpr T mul(T a, T b) {
+        if constexpr (std::is_integral_v<T>) {
+            using U = std::make_unsigned_t<T>;
+            return static_cast<T>(static_cast<U>(a) * static_cast<U>(b));
+        }
+        else {
+            return a * b;
+        }
+    }
+}
+
+/**
+ * @brief Homogeneous linear recurrence of a fixed order:
+ * x(n) = c[0] * x(n - 1) + c[1] * x(n - 2) + ... + c[Order - 1] * x(n - Order).
+ * The order is a template parameter, so every loop over the coefficients has a
+ * constant trip count and is unrolled; a constexpr object is evaluated at
+ * compile time.
+ *
+ * term(n) uses Kitamasa's method for large n: x^n is reduced modulo the
+ * characteristic polynomial by square-and-multiply, which takes
+ * O(Order^2 log n) operations (a matrix power would take O(Order^3 log n)).
+ * fill() computes RECURRENCE_FILL_LANES terms at a time, each directly from
+ * the Order terms before the group, so the lanes are independent and vectorize.
+ *
+ * Integer types wrap around on overflow like unsigned arithmetic and give
+ * exact results modulo 2^bits everywhere. Floating-point results of term()
+ * and fill() are rounded in a different order and may differ in the last bits.
+ */
+template<typename T, std::size_t Order>
+class LinearRecurrence {
+    static_assert(Order >= 1, "Recurrence order must be at least 1");
+
+public:
+    using Coefficients = std::array<T, Order>;
+
+    /**
+     * @param coefficients c[0] .. c[Order - 1], c[j] multiplies x(n - 1 - j)
+     * @param initial x(0) .. x(Order - 1)
+     */
+    constexpr LinearRecurrence(const Coefficients& coefficients, const Coefficients& initial)
+        : coefficients_(coefficients), initial_(initial), lanes_{} {
+        // Lane j expresses x(base + j) in the window x(base - Order) .. x(base - 1)
+        for (std::size_t j = 0; j < RECURRENCE_FILL_LANES; ++j) {
+            for (std::size_t k = 1; k <= Order; ++k) {
+                const T c = coefficients_[k - 1];
+                if (j >= k) {
+                    for (std::size_t m = 0; m < Order; ++m) {
+                        lanes_[m][j] = recurrence_detail::add(lanes_[m][j],
+                            recurrence_detail::mul(c, lanes_[m][j - k]));
+                    }
+                }
+                else {
+                    const std::size_t m = Order + j - k;
+                    lanes_[m][j] = recurrence_detail::add(lanes_[m][j], c);
+                }
+            }
+        }
+    }
+
+    constexpr const Coefficients& coefficients() const {
+        return coefficients_;
+    }
+
+    constexpr const Coefficients& initial() const {
+        return initial_;
+    }
+
+    /**
+     * @brief Returns x(n) (0-based) in O(Order^2 log n); values n < 0 give x(0).
+     */
+    constexpr T term(long long n) const {
+        if (n < static_cast<long long>(Order)) {
+            return initial_[n > 0 ? static_cast<std::size_t>(n) : 0];
+        }
+        if (n < RECURRENCE_JUMP_MIN) {
+            Coefficients window = initial_;
+            for (long long i = static_cast<long long>(Order); i <= n; ++i) {
+                window = next(window);
+            }
+            return window[Order - 1];
+        }
+        return combine(power(n), initial_);
+    }
+
+    /**
+     * @brief Writes x(first) .. x(first + count - 1) to out.
+     * One jump reaches the first Order terms; the rest are computed from the
+     * terms already written.
+     */
+    void fill(long long first, std::size_t count, T* out) const {
+        if (count == 0) {
+            return;
+        }
+        if (first < 0) {
+            first = 0;
+        }
+
+        const std::size_t head = (count < Order) ? count : Order;
+        for (std::size_t i = 0; i < head; ++i) {
+            out[i] = term(first + static_cast<long long>(i));
+        }
+
+        std::size_t i = head;
+        for (; i + RECURRENCE_FILL_LANES <= count; i += RECURRENCE_FILL_LANES) {
+            T values[RECURRENCE_FILL_LANES] = {};
+            for (std::size_t m = 0; m < Order; ++m) {
+                const T w = out[i - Order + m];
+                for (std::size_t j = 0; j < RECURRENCE_FILL_LANES; ++j) {
+                    values[j] = recurrence_detail::add(values[j], recurrence_detail::mul(lanes_[m][j], w));
+                }
+            }
+            for (std::size_t j = 0; j < RECURRENCE_FILL_LANES; ++j) {
+                out[i + j] = values[j];
+            }
+        }
+        for (; i < count; ++i) {
+            out[i] = step(out + i);
+        }
+    }
+
+private:
+    using Product = std::array<T, 2 * Order - 1>;
+
+    /**
+     * @brief Next term from the Order terms ending just before at.
+     */
+    constexpr T step(const T* at) const {
+        T value{};
+        for (std::size_t k = 1; k <= Order; ++k) {
+            value = recurrence_detail::add(value, recurrence_detail::mul(coefficients_[k - 1], at[-static_cast<std::ptrdiff_t>(k)]));
+        }
+        return value;
+    }
+
+    /**
+     * @brief Shifts the window x(i - Order) .. x(i - 1) by one term.
+     */
+    constexpr Coefficients next(const Coefficients& window) const {
+        Coefficients shifted{};
+        for (std::size_t m = 0; m + 1 < Order; ++m) {
+            shifted[m] = window[m + 1];
+        }
+        T value{};
+        for (std::size_t k = 1; k <= Order; ++k) {
+            value = recurrence_detail::add(value, recurrence_detail::mul(coefficients_[k - 1], window[Order - k]));
+        }
+        shifted[Order - 1] = value;
+        return shifted;
+    }
+
+    /**
+     * @brief a * b modulo the characteristic polynomial
+     * x^Order - c[0] x^(Order - 1) - ... - c[Order - 1].
+     */
+    constexpr Coefficients multiply(const Coefficients& a, const Coefficients& b) const {
+        Product product{};
+        for (std::size_t i = 0; i < Order; ++i) {
+            for (std::size_t j = 0; j < Order; ++j) {
+                product[i + j] = recurrence_detail::add(product[i + j], recurrence_detail::mul(a[i], b[j]));
+            }
+        }
+        // x^d = c[0] x^(d - 1) + ... + c[Order - 1] x^(d - Order), highest degree first
+        for (std::size_t d = 2 * Order - 2; d >= Order; --d) {
+            const T top = product[d];
+            for (std::size_t k = 1; k <= Order; ++k) {
+                product[d - k] = recurrence_detail::add(product[d - k], recurrence_detail::mul(top, coefficients_[k - 1]));
+            }
+        }
+
+        Coefficients reduced{};
+        for (std::size_t i = 0; i < Order; ++i) {
+            reduced[i] = product[i];
+        }
+        return reduced;
+    }
+
+    /**
+     * @brief x^n modulo the characteristic polynomial, so x(n) = sum p[m] * x(m).
+     */
+    constexpr Coefficients power(long long n) const {
+        Coefficients result{};
+        result[0] = T(1);
+        Coefficients base{};
+        if constexpr (Order == 1) {
+            base[0] = coefficients_[0];
+        }
+        else {
+            base[1] = T(1);
+        }
+
+        for (unsigned long long e = static_cast<unsigned long long>(n); e > 0; e >>= 1) {
+            if (e & 1) {
+                result = multiply(result, base);
+            }
+            if (e > 1) {
+                base = multiply(base, base);
+            }
+        }
+        return result;
+    }
+
+    constexpr T combine(const Coefficients& weights, const Coefficients& values) const {
+        T value{};
+        for (std::size_t m = 0; m < Order; ++m) {
+            value = recurrence_detail::add(value, recurrence_detail::mul(weights[m], values[m]));
+        }
+        return value;
+    }
+
+    Coefficients coefficients_;
+    Coefficients initial_;
+    std::array<std::array<T, RECURRENCE_FILL_LANES>, Order> lanes_;     ///< lanes_[m][j]: weight of window term m in lane j
+};
+
+// ============================================================================
+// COMMON SEQUENCES
+// ============================================================================
+
+/**
+ * @brief F(0) = 0, F(1) = 1, F(n) = F(n - 1) + F(n - 2); exact up to F(92).
+ */
+inline constexpr LinearRecurrence<long long, 2> FIBONACCI({ 1, 1 }, { 0, 1 });
+
+static_assert(FIBONACCI.term(10) == 55 && FIBONACCI.term(92) == 7540113804746346429LL,
+    "Fibonacci recurrence is wrong");
+
+/**
+ * @brief Arithmetic progression x(n) = a0 + n * d as x(n) = 2 x(n - 1) - x(n - 2).
+ * For floating point prefer sequenceTerm(), which rounds once per term.
+ */
+template<typename T>
+constexpr LinearRecurrence<T, 2> arithmeticRecurrence(T a0, T d) {
+    return LinearRecurrence<T, 2>({ T(2), T(-1) }, { a0, a0 + d });
+}
+
+/**
+ * @brief Geometric progression x(n) = b0 * q^n.
+ */
+template<typename T>
+constexpr LinearRecurrence<T, 1> geometricRecurrence(T b0, T q) {
+    return LinearRecurrence<T, 1>({ q }, { b0 });
+}
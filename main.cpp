@@ -1,8 +1,19 @@
+#include <algorithm>
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
 #include <cstdlib>
+#include <limits>
 #include <string>
 
-// Task enumeration for compile-time task selection
+#include "batch_executor.h"
+#include "instrumentation.h"
+#include "output_sink.h"
+#include "sequence_queries.h"
+#include "tasks.h"
+
+// Task enumeration for task selection
 enum class TaskID {
     TASK_1 = 1,
     TASK_2 = 2,
@@ -12,11 +23,37 @@ enum class TaskID {
     TASK_6 = 6
 };
 
-// Current task to execute - change this value to switch tasks
+// Task executed when no --task argument is given - change this value to switch the default
 constexpr TaskID CURRENT_TASK = TaskID::TASK_1;
 
 using namespace std;
 
+/**
+ * @brief Options collected from the command line.
+ * Empty paths mean "use the task's default file".
+ */
+struct RunOptions {
+    TaskID task = CURRENT_TASK;
+    string inputPath;
+    string outputPath;
+    string fibonacciOutputPath;    ///< Second output of task 5
+    bool batch = false;            ///< No screen clear, no banner, no pause
+    bool quiet = false;            ///< Suppress everything written to cout
+    bool statsOnly = false;        ///< Task 2: write statistics without the terms
+    bool product = false;          ///< Task 3: also write the product A x B^T
+    bool hasAnswers = false;
+    string answers;                ///< Prompt answers; ';' separates lines
+    string scriptPath;             ///< File whose contents replace stdin
+    bool hasOutputMode = false;
+    OutputMode outputMode = OutputMode::DUAL;
+    string profilePath;            ///< Phase timing report; .csv appends a row, otherwise JSON
+    string jobListPath;            ///< Run the jobs of this list concurrently instead of one task
+    size_t threads = 0;            ///< Workers for the job list; 0 = one per hardware thread
+    string queryPath;              ///< Evaluate the progression queries of this file instead of one task
+    QueryFormat queryFormat = QueryFormat::TEXT;
+    string convertPath;            ///< Convert the task 3 or 5 input to this file instead of running the task
+};
+
 /**
  * @brief Clears the console screen in a cross-platform manner.
  * Uses preprocessor directives to handle Windows (cls) and Unix-like systems (clear).
@@ -42,53 +79,421 @@ void pauseConsole() {
     cin.get();
 }
 
-// Forward declarations for all task functions
-void task1();
-void task2();
-void task3();
-void task4();
-void task5();
-void task6();
+/**
+ * @brief Prints command-line usage.
+ * @param out Stream to print to
+ */
+void printUsage(ostream& out) {
+    out << "Usage: cpp-it-lab-works [options]\n"
+        << "  --task N             Task to run (1-6)\n"
+        << "  --input PATH         Input file of the task\n"
+        << "  --output PATH        Output file of the task\n"
+        << "  --fib-output PATH    Fibonacci output file (task 5)\n"
+        << "  --batch              Non-interactive: no screen clear, no pause\n"
+        << "  --answers TEXT       Answers to the prompts, ';' separates lines\n"
+        << "  --script PATH        Read the answers to the prompts from a file\n"
+        << "  --output-mode MODE   dual, console, file, mapped, memory or discard\n"
+        << "                       (default: dual, file in batch mode)\n"
+        << "  --quiet              Suppress console output (prompts included)\n"
+        << "  --stats-only         Task 2: write sums and averages without the terms\n"
+        << "  --product            Task 3: also write the matrix product A x B^T\n"
+        << "  --profile PATH       Write phase timings and counters (JSON, or CSV if PATH ends in .csv)\n"
+        << "  --jobs PATH          Run a job list concurrently (one job per line:\n"
+        << "                       task | input | output | fib-output | answers)\n"
+        << "  --threads N          Worker threads for --jobs and --queries (default: hardware threads)\n"
+        << "  --queries PATH       Evaluate progression queries, one \"a0 d n [limit]\" per line\n"
+        << "  --query-format FMT   text (fixed-width lines, default) or binary (48-byte records)\n"
+        << "  --convert PATH       Tasks 3, 5: convert --input between text and binary matrix files\n"
+        << "  --help               Show this message\n";
+}
+
+/**
+ * @brief Converts an --output-mode value to OutputMode.
+ * @param name Mode name
+ * @param mode Parsed mode (output)
+ * @return false if the name is unknown
+ */
+bool parseOutputMode(const string& name, OutputMode& mode) {
+    if (name == "dual") mode = OutputMode::DUAL;
+    else if (name == "console") mode = OutputMode::CONSOLE_ONLY;
+    else if (name == "file") mode = OutputMode::FILE_ONLY;
+    else if (name == "mapped") mode = OutputMode::MAPPED_FILE;
+    else if (name == "memory") mode = OutputMode::MEMORY_ONLY;
+    else if (name == "discard") mode = OutputMode::DISCARD;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Parses command-line arguments into RunOptions.
+ * @param argc Argument count
+ * @param argv Argument values
+ * @param options Parsed options (output)
+ * @return false if the arguments are invalid or --help was requested
+ */
+bool parseArguments(int argc, char* argv[], RunOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+
+        if (arg == "--help") {
+            printUsage(cout);
+            return false;
+        }
+        if (arg == "--batch") {
+            options.batch = true;
+            continue;
+        }
+        if (arg == "--quiet") {
+            options.quiet = true;
+            continue;
+        }
+        if (arg == "--stats-only") {
+            options.statsOnly = true;
+            continue;
+        }
+        if (arg == "--product") {
+            options.product = true;
+            continue;
+        }
+
+        // All remaining options take a value
+        const bool known = arg == "--task" || arg == "--input" || arg == "--output"
+            || arg == "--fib-output" || arg == "--answers" || arg == "--script" || arg == "--output-mode"
+            || arg == "--profile" || arg == "--jobs" || arg == "--threads" || arg == "--queries"
+            || arg == "--query-format" || arg == "--convert";
+        if (!known) {
+            cerr << "Unknown option: " << arg << "\n";
+            printUsage(cerr);
+            return false;
+        }
+        if (i + 1 >= argc) {
+            cerr << "Missing value for option: " << arg << "\n";
+            return false;
+        }
+        string value = argv[++i];
+
+        if (arg == "--task") {
+            int id = atoi(value.c_str());
+            if (id < 1 || id > 6) {
+                cerr << "Invalid task ID: " << value << " (expected 1-6)\n";
+                return false;
+            }
+            options.task = static_cast<TaskID>(id);
+        }
+        else if (arg == "--input") {
+            options.inputPath = value;
+        }
+        else if (arg == "--output") {
+            options.outputPath = value;
+        }
+        else if (arg == "--fib-output") {
+            options.fibonacciOutputPath = value;
+        }
+        else if (arg == "--answers") {
+            options.hasAnswers = true;
+            options.answers = value;
+        }
+        else if (arg == "--script") {
+            options.scriptPath = value;
+        }
+        else if (arg == "--output-mode") {
+            if (!parseOutputMode(value, options.outputMode)) {
+                cerr << "Invalid output mode: " << value << "\n";
+                return false;
+            }
+            options.hasOutputMode = true;
+        }
+        else if (arg == "--profile") {
+            options.profilePath = value;
+        }
+        else if (arg == "--jobs") {
+            options.jobListPath = value;
+        }
+        else if (arg == "--queries") {
+            options.queryPath = value;
+        }
+        else if (arg == "--query-format") {
+            if (value == "text") options.queryFormat = QueryFormat::TEXT;
+            else if (value == "binary") options.queryFormat = QueryFormat::BINARY;
+            else {
+                cerr << "Invalid query format: " << value << "\n";
+                return false;
+            }
+        }
+        else if (arg == "--convert") {
+            options.convertPath = value;
+        }
+        else if (arg == "--threads") {
+            int threads = atoi(value.c_str());
+            if (threads < 1) {
+                cerr << "Invalid thread count: " << value << "\n";
+                return false;
+            }
+            options.threads = static_cast<size_t>(threads);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Runs the selected task with the paths from the options.
+ * @param options Parsed command-line options
+ */
+void runTask(const RunOptions& options) {
+    BatchJob job;
+    job.task = static_cast<int>(options.task);
+    job.inputPath = options.inputPath;
+    job.outputPath = options.outputPath;
+    job.fibonacciOutputPath = options.fibonacciOutputPath;
+    job.printTerms = !options.statsOnly;
+    job.printProduct = options.product;
+    runJob(job);
+}
+
+/**
+ * @brief Writes the instrumentation report of the finished run.
+ * A .csv path gets one row appended per run (with a header when the file is new);
+ * any other path is overwritten with a JSON document.
+ * @param path Report file
+ * @param task Task that was run (0 for a job list)
+ * @param wallNs Wall-clock time of the run
+ */
+void writeProfile(const string& path, int task, uint64_t wallNs) {
+    const bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+    bool header = false;
+    if (csv) {
+        ifstream existing(path, ios::binary | ios::ate);
+        header = !existing.is_open() || existing.tellg() <= 0;
+    }
+
+    ofstream report(path, csv ? ios::app : ios::trunc);
+    if (!report.is_open()) {
+        cerr << "Cannot open output file: " << path << "\n";
+        return;
+    }
+
+    if (csv) {
+        instrumentation::writeCsv(report, task, wallNs, header);
+    }
+    else {
+        instrumentation::writeJson(report, task, wallNs);
+    }
+}
+
+/**
+ * @brief Runs the jobs of --jobs concurrently and prints the batch report.
+ * Job output goes to the job files only unless --output-mode says otherwise.
+ * @param options Parsed command-line options
+ * @return int Exit code (1 if the list is invalid or a job reported errors)
+ */
+int runJobList(const RunOptions& options) {
+    vector<BatchJob> jobs;
+    try {
+        jobs = readJobList(options.jobListPath);
+    }
+    catch (const runtime_error& e) {
+        cerr << "Batch Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    for (auto& job : jobs) {
+        job.printTerms = !options.statsOnly;
+        job.printProduct = options.product;
+    }
+    setOutputMode(options.hasOutputMode ? options.outputMode : OutputMode::FILE_ONLY);
+
+    const bool profiling = !options.profilePath.empty();
+    if (profiling) {
+        instrumentation::reset();
+        instrumentation::enable(true);
+    }
+
+    BatchReport report;
+    {
+        ThreadPool pool(options.threads);
+        report = runBatch(jobs, pool);
+    }
+
+    if (profiling) {
+        instrumentation::enable(false);
+        writeProfile(options.profilePath, 0, report.wallNs);
+    }
+
+    if (!options.quiet) {
+        printBatchReport(report, cout);
+    }
+
+    bool failed = any_of(report.jobs.begin(), report.jobs.end(),
+        [](const JobResult& result) { return !result.errors.empty(); });
+    return failed ? 1 : 0;
+}
+
+/**
+ * @brief Evaluates the query file of --queries and reports the throughput.
+ * Results go to --output (default output_queries.txt or .bin), file only
+ * unless --output-mode says otherwise.
+ * @param options Parsed command-line options
+ * Invalid rows are skipped and reported after the valid ones are written.
+ * @return int Exit code (1 if a file cannot be opened or a row is invalid)
+ */
+int runQueries(const RunOptions& options) {
+    const bool binary = options.queryFormat == QueryFormat::BINARY;
+    const string outputPath = !options.outputPath.empty() ? options.outputPath
+        : binary ? "output_queries.bin" : "output_queries.txt";
+    setOutputMode(options.hasOutputMode ? options.outputMode : OutputMode::FILE_ONLY);
+
+    const bool profiling = !options.profilePath.empty();
+    if (profiling) {
+        instrumentation::reset();
+        instrumentation::enable(true);
+    }
+    auto start = chrono::steady_clock::now();
+
+    QueryRunSummary summary;
+    try {
+        ThreadPool pool(options.threads);
+        summary = runSequenceQueries(options.queryPath, outputPath, options.queryFormat, pool);
+    }
+    catch (const runtime_error& e) {
+        cerr << "Query Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    auto wall = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+    if (profiling) {
+        instrumentation::enable(false);
+        writeProfile(options.profilePath, 2, static_cast<uint64_t>(wall.count()));
+    }
+
+    if (!options.quiet) {
+        const double seconds = static_cast<double>(wall.count()) / 1e9;
+        cout << "Evaluated " << summary.queries << " queries in " << seconds * 1e3 << " ms ("
+            << (seconds > 0 ? static_cast<double>(summary.queries) / seconds : 0.0) << " queries/s), results in "
+            << outputPath << "\n";
+    }
+    if (summary.skipped > 0) {
+        cerr << "Query Error: skipped " << summary.skipped << " invalid row(s), first: '"
+            << summary.firstInvalidRow << "'\n";
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Converts the input of task 3 or 5 for --convert.
+ * A text input becomes a binary matrix file and a binary one becomes text.
+ * @param options Parsed command-line options
+ * @return int Exit code (1 for another task or a file that cannot be converted)
+ */
+int runConversion(const RunOptions& options) {
+    if (options.task != TaskID::TASK_3 && options.task != TaskID::TASK_5) {
+        cerr << "--convert applies to task 3 or 5\n";
+        return 1;
+    }
+
+    const bool task3Input = options.task == TaskID::TASK_3;
+    const string inputPath = !options.inputPath.empty() ? options.inputPath
+        : task3Input ? TASK3_INPUT : TASK5_INPUT;
+    try {
+        if (task3Input) {
+            convertTask3Input(inputPath, options.convertPath);
+        }
+        else {
+            convertTask5Input(inputPath, options.convertPath);
+        }
+    }
+    catch (const runtime_error& e) {
+        cerr << "Conversion Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    if (!options.quiet) {
+        cout << "Converted " << inputPath << " to " << options.convertPath << "\n";
+    }
+    return 0;
+}
 
 /**
- * @brief Executes the currently selected task based on CURRENT_TASK constant.
- * Uses compile-time if-constexpr for zero runtime overhead.
+ * @brief Executes the task selected on the command line (or CURRENT_TASK).
+ * Interactive mode clears the screen and pauses at the end; batch mode does
+ * neither and takes prompt answers from --answers, --script or stdin.
  *
  * @return int Exit code (0 for success)
  */
-int main() {
-    clearScreen();
+int main(int argc, char* argv[]) {
+    RunOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+    if (!options.jobListPath.empty()) {
+        return runJobList(options);
+    }
+    if (!options.queryPath.empty()) {
+        return runQueries(options);
+    }
+    if (!options.convertPath.empty()) {
+        return runConversion(options);
+    }
 
-    // Execute selected task based on compile-time constant
-    if constexpr (CURRENT_TASK == TaskID::TASK_1) {
-        cout << "EXECUTING TASK 1" << endl;
-        task1();
+    // Replace stdin with prepared answers; the stream must outlive the task
+    streambuf* keyboard = cin.rdbuf();
+    istringstream answers;
+    ifstream script;
+    if (options.hasAnswers) {
+        string text = options.answers;
+        for (char& c : text) {
+            if (c == ';') c = '\n';
+        }
+        answers.str(text + "\n");
+        cin.rdbuf(answers.rdbuf());
     }
-    else if constexpr (CURRENT_TASK == TaskID::TASK_2) {
-        cout << "EXECUTING TASK 2" << endl;
-        task2();
+    else if (!options.scriptPath.empty()) {
+        script.open(options.scriptPath);
+        if (!script.is_open()) {
+            cerr << "Cannot open script file: " << options.scriptPath << "\n";
+            return 1;
+        }
+        cin.rdbuf(script.rdbuf());
     }
-    else if constexpr (CURRENT_TASK == TaskID::TASK_3) {
-        cout << "EXECUTING TASK 3" << endl;
-        task3();
+
+    if (options.hasOutputMode) {
+        setOutputMode(options.outputMode);
     }
-    else if constexpr (CURRENT_TASK == TaskID::TASK_4) {
-        cout << "EXECUTING TASK 4" << endl;
-        task4();
+    else if (options.batch) {
+        setOutputMode(OutputMode::FILE_ONLY);
     }
-    else if constexpr (CURRENT_TASK == TaskID::TASK_5) {
-        cout << "EXECUTING TASK 5" << endl;
-        task5();
+
+    streambuf* console = cout.rdbuf();
+    if (options.quiet) {
+        cout.rdbuf(nullptr);  // Writes to cout are dropped
     }
-    else if constexpr (CURRENT_TASK == TaskID::TASK_6) {
-        cout << "EXECUTING TASK 6" << endl;
-        task6();
+
+    if (!options.batch) {
+        clearScreen();
+        cout << "EXECUTING TASK " << static_cast<int>(options.task) << endl;
     }
-    else {
-        cerr << "NO TASK SELECTED OR INVALID ID" << endl;
-        return 1;
+
+    const bool profiling = !options.profilePath.empty();
+    if (profiling) {
+        instrumentation::reset();
+        instrumentation::enable(true);
     }
+    auto start = chrono::steady_clock::now();
 
-    pauseConsole();
+    runTask(options);
+
+    if (profiling) {
+        auto wall = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+        instrumentation::enable(false);
+        writeProfile(options.profilePath, static_cast<int>(options.task), static_cast<uint64_t>(wall.count()));
+    }
+
+    if (!options.batch) {
+        pauseConsole();
+    }
+
+    // Restore the original buffers before the local streams are destroyed
+    cout.rdbuf(console);
+    cin.rdbuf(keyboard);
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,313 @@
+#include "mapped_file.h"
+#include "instrumentation.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+    /**
+     * @brief Rounds a byte count up to a whole number of extents.
+     */
+    size_t roundToExtent(size_t size) {
+        constexpr size_t extent = MappedOutputFile::EXTENT_SIZE;
+        return (size + extent - 1) / extent * extent;
+    }
+}
+
+// ============================================================================
+// MAPPED INPUT FILE
+// ============================================================================
+
+MappedInputFile::MappedInputFile(const string& filepath) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    open_ = true;
+
+    LARGE_INTEGER length;
+    if (GetFileSizeEx(file, &length) && length.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);  // The view keeps the mapping alive
+            if (view != nullptr) {
+                data_ = static_cast<const char*>(view);
+                size_ = static_cast<size_t>(length.QuadPart);
+                mapped_ = true;
+            }
+        }
+        if (!mapped_) {
+            open_ = false;
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    open_ = true;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+            madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(view);
+            size_ = static_cast<size_t>(info.st_size);
+            mapped_ = true;
+        }
+        else {
+            open_ = false;
+        }
+    }
+    ::close(fd);  // The mapping stays valid after the descriptor is closed
+#endif
+    LAB_COUNT(Counter::BYTES_IN, size_);
+}
+
+MappedInputFile::~MappedInputFile() {
+    if (!mapped_) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+#else
+    munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+// ============================================================================
+// MAPPED OUTPUT FILE
+// ============================================================================
+
+MappedOutputFile::MappedOutputFile(const string& filepath, bool append, size_t initialCapacity)
+    : path_(filepath) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+        append ? OPEN_ALWAYS : CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw runtime_error("Cannot open output file: " + filepath);
+    }
+    file_ = file;
+
+    if (append) {
+        LARGE_INTEGER existing;
+        GetFileSizeEx(file, &existing);
+        size_ = static_cast<size_t>(existing.QuadPart);
+    }
+#else
+    fd_ = ::open(filepath.c_str(), O_RDWR | O_CREAT | (append ? 0 : O_TRUNC), 0644);
+    if (fd_ < 0) {
+        throw runtime_error("Cannot open output file: " + filepath);
+    }
+
+    if (append) {
+        struct stat info;
+        if (fstat(fd_, &info) == 0) {
+            size_ = static_cast<size_t>(info.st_size);
+        }
+    }
+#endif
+
+    try {
+        reserve(size_ + (initialCapacity > 0 ? initialCapacity : 1));
+    }
+    catch (...) {
+        close();
+        throw;
+    }
+}
+
+MappedOutputFile::~MappedOutputFile() {
+    close();
+}
+
+/**
+ * @brief Makes sure at least capacity bytes are allocated on disk and mapped.
+ */
+void MappedOutputFile::reserve(size_t capacity) {
+    if (capacity <= capacity_) {
+        return;
+    }
+
+    size_t newCapacity = roundToExtent(capacity);
+    unmap();
+
+#ifdef _WIN32
+    // CreateFileMapping extends the file to the mapping size
+    map(newCapacity);
+#else
+    int error = posix_fallocate(fd_, 0, static_cast<off_t>(newCapacity));
+    if (error != 0 && ftruncate(fd_, static_cast<off_t>(newCapacity)) != 0) {
+        throw runtime_error("Cannot preallocate output file: " + path_);
+    }
+    map(newCapacity);
+#endif
+}
+
+void MappedOutputFile::map(size_t capacity) {
+#ifdef _WIN32
+    ULARGE_INTEGER length;
+    length.QuadPart = capacity;
+    HANDLE mapping = CreateFileMappingA(static_cast<HANDLE>(file_), nullptr, PAGE_READWRITE,
+        length.HighPart, length.LowPart, nullptr);
+    if (mapping == nullptr) {
+        throw runtime_error("Cannot map output file: " + path_);
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, capacity);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        throw runtime_error("Cannot map output file: " + path_);
+    }
+    mapping_ = mapping;
+    data_ = static_cast<char*>(view);
+#else
+    void* view = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (view == MAP_FAILED) {
+        throw runtime_error("Cannot map output file: " + path_);
+    }
+    data_ = static_cast<char*>(view);
+#endif
+    capacity_ = capacity;
+}
+
+void MappedOutputFile::unmap() {
+    if (data_ == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(static_cast<HANDLE>(mapping_));
+    mapping_ = nullptr;
+#else
+    munmap(data_, capacity_);
+#endif
+    data_ = nullptr;
+    capacity_ = 0;
+}
+
+void MappedOutputFile::append(const char* data, size_t size) {
+    if (size_ + size > capacity_) {
+        reserve(size_ + size);
+    }
+    memcpy(data_ + size_, data, size);
+    size_ += size;
+}
+
+void MappedOutputFile::resize(size_t size) {
+    reserve(size);
+    size_ = size;
+}
+
+void MappedOutputFile::flush() {
+    if (data_ == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    FlushViewOfFile(data_, size_);
+#else
+    msync(data_, size_, MS_ASYNC);
+#endif
+}
+
+void MappedOutputFile::close() {
+    unmap();
+
+#ifdef _WIN32
+    if (file_ != nullptr) {
+        LARGE_INTEGER end;
+        end.QuadPart = static_cast<LONGLONG>(size_);
+        SetFilePointerEx(static_cast<HANDLE>(file_), end, nullptr, FILE_BEGIN);
+        SetEndOfFile(static_cast<HANDLE>(file_));
+        CloseHandle(static_cast<HANDLE>(file_));
+        file_ = nullptr;
+    }
+#else
+    if (fd_ >= 0) {
+        // Trim the preallocated tail; on failure the file only keeps trailing zeros
+        int trimmed = ftruncate(fd_, static_cast<off_t>(size_));
+        (void)trimmed;
+        ::close(fd_);
+        fd_ = -1;
+    }
+#endif
+}
+
+// ============================================================================
+// POSITIONAL FILE
+// ============================================================================
+
+PositionalFile::PositionalFile(const string& filepath)
+    : path_(filepath) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw runtime_error("Cannot open output file: " + filepath);
+    }
+    file_ = file;
+#else
+    fd_ = ::open(filepath.c_str(), O_WRONLY);
+    if (fd_ < 0) {
+        throw runtime_error("Cannot open output file: " + filepath);
+    }
+#endif
+}
+
+PositionalFile::~PositionalFile() {
+#ifdef _WIN32
+    if (file_ != nullptr) {
+        CloseHandle(static_cast<HANDLE>(file_));
+    }
+#else
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+}
+
+void PositionalFile::write(uint64_t offset, const char* data, size_t size) {
+    // Both calls may write less than asked; continue from where they stopped
+    while (size > 0) {
+#ifdef _WIN32
+        OVERLAPPED position = {};
+        position.Offset = static_cast<DWORD>(offset);
+        position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        DWORD chunk = static_cast<DWORD>(min<size_t>(size, 1u << 30));
+        DWORD written = 0;
+        if (!WriteFile(static_cast<HANDLE>(file_), data, chunk, &written, &position) || written == 0) {
+            throw runtime_error("Cannot write output file: " + path_);
+        }
+#else
+        ssize_t written = ::pwrite(fd_, data, size, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            throw runtime_error("Cannot write output file: " + path_);
+        }
+#endif
+        offset += static_cast<uint64_t>(written);
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Read-only memory mapping of a whole input file.
+ * Parsers read the bytes in place (see TextScanner) instead of copying them
+ * through ifstream buffers. Follows the ifstream convention: a missing file
+ * does not throw, is_open() reports it so callers keep their own messages.
+ */
+class MappedInputFile {
+public:
+    /**
+     * @brief Opens and maps the file.
+     * @param filepath Path to the input file
+     */
+    explicit MappedInputFile(const std::string& filepath);
+
+    /**
+     * @brief Unmaps and closes the file (RAII pattern).
+     */
+    ~MappedInputFile();
+
+    MappedInputFile(const MappedInputFile&) = delete;
+    MappedInputFile& operator=(const MappedInputFile&) = delete;
+
+    /**
+     * @brief Returns true if the file was opened (an empty file counts as open).
+     */
+    bool is_open() const {
+        return open_;
+    }
+
+    const char* begin() const {
+        return data_;
+    }
+
+    const char* end() const {
+        return data_ + size_;
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+    /**
+     * @brief Returns the whole file contents.
+     */
+    std::string_view view() const {
+        return std::string_view(data_, size_);
+    }
+
+private:
+    const char* data_ = "";
+    std::size_t size_ = 0;
+    bool open_ = false;
+    bool mapped_ = false;
+};
+
+/**
+ * @brief Output file written through a memory mapping instead of ofstream.
+ * Disk space is preallocated in large extents (fallocate on POSIX, file size
+ * extension on Windows) and formatted bytes are copied straight into the
+ * mapping. On close the file is truncated to the bytes actually written.
+ *
+ * Sequential use: append(). Parallel use: resize() to the final size once,
+ * then let each thread fill its own disjoint range through at(); no locking
+ * is needed because the mapping does not move until the next resize().
+ */
+class MappedOutputFile {
+public:
+    static constexpr std::size_t EXTENT_SIZE = 64u * 1024 * 1024;
+
+    /**
+     * @brief Creates (or opens for append) the file and maps the first extent.
+     * @param filepath Path to the output file
+     * @param append If true, keeps existing contents and writes after them
+     * @param initialCapacity Bytes to preallocate up front
+     * @throws runtime_error if the file cannot be created, grown or mapped
+     */
+    explicit MappedOutputFile(const std::string& filepath, bool append = false,
+        std::size_t initialCapacity = EXTENT_SIZE);
+
+    /**
+     * @brief Unmaps the file and trims it to the written size (RAII pattern).
+     */
+    ~MappedOutputFile();
+
+    MappedOutputFile(const MappedOutputFile&) = delete;
+    MappedOutputFile& operator=(const MappedOutputFile&) = delete;
+
+    /**
+     * @brief Appends bytes at the end of the file, growing the mapping if needed.
+     * @param data Bytes to write
+     * @param size Number of bytes
+     */
+    void append(const char* data, std::size_t size);
+
+    /**
+     * @brief Sets the logical file size, growing the mapping if needed.
+     * Invalidates pointers previously returned by at().
+     * @param size New size in bytes
+     */
+    void resize(std::size_t size);
+
+    /**
+     * @brief Returns a writable pointer to the given offset (offset < size()).
+     */
+    char* at(std::size_t offset) {
+        return data_ + offset;
+    }
+
+    /**
+     * @brief Returns the logical size of the file in bytes.
+     */
+    std::size_t size() const {
+        return size_;
+    }
+
+    /**
+     * @brief Asks the OS to write dirty pages back to disk.
+     */
+    void flush();
+
+    /**
+     * @brief Unmaps and trims the file; further writes are not allowed.
+     */
+    void close();
+
+private:
+    void reserve(std::size_t capacity);
+    void map(std::size_t capacity);
+    void unmap();
+
+    std::string path_;
+    char* data_ = nullptr;
+    std::size_t size_ = 0;        ///< Bytes written (logical file size)
+    std::size_t capacity_ = 0;    ///< Bytes preallocated and mapped
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+/**
+ * @brief Existing file opened for writes at explicit offsets (pwrite on POSIX,
+ * WriteFile with an OVERLAPPED offset on Windows).
+ * The file position is never used, so several threads may write disjoint
+ * ranges at the same time. Does not truncate the file.
+ */
+class PositionalFile {
+public:
+    /**
+     * @brief Opens the file for writing.
+     * @param filepath Path to an existing file
+     * @throws runtime_error if the file cannot be opened
+     */
+    explicit PositionalFile(const std::string& filepath);
+
+    /**
+     * @brief Closes the file (RAII pattern).
+     */
+    ~PositionalFile();
+
+    PositionalFile(const PositionalFile&) = delete;
+    PositionalFile& operator=(const PositionalFile&) = delete;
+
+    /**
+     * @brief Writes all bytes at the given offset, extending the file if needed.
+     * @param offset Absolute position in the file
+     * @param data Bytes to write
+     * @param size Number of bytes
+     * @throws runtime_error if the write fails
+     */
+    void write(std::uint64_t offset, const char* data, std::size_t size);
+
+private:
+    std::string path_;
+#ifdef _WIN32
+    void* file_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
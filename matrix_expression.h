@@ -0,0 +1,214 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "dynamic_matrix.h"
+#include "elementwise.h"
+
+/**
+ * @brief Base of the element-wise matrix expressions (CRTP).
+ * An expression such as elementMax(a, b) - a * b is a tree of small objects
+ * that only describe the computation. Nothing is computed, and no matrix is
+ * allocated, until evaluate() or evaluateInto() walks every row once and
+ * computes each element of the result directly from the input elements.
+ *
+ * Every node provides rows(), cols() and row(i); row(i)[j] is element (i, j).
+ */
+template<typename E>
+struct MatrixExpression {
+    const E& derived() const {
+        return static_cast<const E&>(*this);
+    }
+};
+
+/**
+ * @brief Leaf of an expression: a matrix read through a view.
+ * The matrix must outlive the expression; the operators below therefore
+ * reject a temporary DynamicMatrix.
+ */
+class MatrixTerminal : public MatrixExpression<MatrixTerminal> {
+public:
+    explicit MatrixTerminal(ConstMatrixView view) : view_(view) {}
+
+    std::size_t rows() const {
+        return view_.rows();
+    }
+
+    std::size_t cols() const {
+        return view_.cols();
+    }
+
+    const double* row(std::size_t i) const {
+        return view_[i];
+    }
+
+private:
+    ConstMatrixView view_;
+};
+
+/**
+ * @brief Node applying Op to corresponding elements of two subexpressions.
+ * Subexpressions are held by value; they are views and other nodes, both small.
+ */
+template<typename Op, typename Left, typename Right>
+class BinaryExpression : public MatrixExpression<BinaryExpression<Op, Left, Right>> {
+public:
+    /**
+     * @brief Element access to row i of both operands.
+     */
+    struct Row {
+        decltype(std::declval<const Left&>().row(0)) left;
+        decltype(std::declval<const Right&>().row(0)) right;
+
+        double operator[](std::size_t j) const {
+            return Op()(left[j], right[j]);
+        }
+    };
+
+    /**
+     * @throws invalid_argument if the operands differ in shape
+     */
+    BinaryExpression(Left left, Right right) : left_(std::move(left)), right_(std::move(right)) {
+        if (left_.rows() != right_.rows() || left_.cols() != right_.cols()) {
+            throw std::invalid_argument("Matrix dimensions do not match");
+        }
+    }
+
+    std::size_t rows() const {
+        return left_.rows();
+    }
+
+    std::size_t cols() const {
+        return left_.cols();
+    }
+
+    Row row(std::size_t i) const {
+        return Row{ left_.row(i), right_.row(i) };
+    }
+
+private:
+    Left left_;
+    Right right_;
+};
+
+namespace expression_detail {
+    inline MatrixTerminal operand(ConstMatrixView view) {
+        return MatrixTerminal(view);
+    }
+
+    template<typename E>
+    const E& operand(const MatrixExpression<E>& expression) {
+        return expression.derived();
+    }
+
+    template<typename T>
+    using OperandType = std::decay_t<decltype(operand(std::declval<const T&>()))>;
+
+    template<typename Op, typename L, typename R>
+    BinaryExpression<Op, OperandType<L>, OperandType<R>> combine(const L& left, const R& right) {
+        return BinaryExpression<Op, OperandType<L>, OperandType<R>>(operand(left), operand(right));
+    }
+}
+
+/**
+ * @brief Types that can appear in an expression: matrices, views and expressions.
+ */
+template<typename T>
+concept MatrixOperand = std::same_as<T, DynamicMatrix> || std::same_as<T, MatrixView>
+    || std::same_as<T, ConstMatrixView> || std::is_base_of_v<MatrixExpression<T>, T>;
+
+/**
+ * @brief Operand type as deduced by the operators' forwarding references.
+ * A DynamicMatrix rvalue is rejected: the expression would keep a view of a
+ * temporary destroyed at the end of the statement, so
+ * "auto e = makeMatrix() + b;" does not compile.
+ */
+template<typename T>
+concept MatrixArgument = MatrixOperand<std::remove_cvref_t<T>>
+    && (std::is_lvalue_reference_v<T> || !std::same_as<std::remove_cvref_t<T>, DynamicMatrix>);
+
+template<MatrixArgument L, MatrixArgument R>
+auto operator+(L&& left, R&& right) {
+    return expression_detail::combine<AddOp>(left, right);
+}
+
+template<MatrixArgument L, MatrixArgument R>
+auto operator-(L&& left, R&& right) {
+    return expression_detail::combine<SubtractOp>(left, right);
+}
+
+template<MatrixArgument L, MatrixArgument R>
+auto operator*(L&& left, R&& right) {
+    return expression_detail::combine<MultiplyOp>(left, right);
+}
+
+/**
+ * @brief Element-wise division that yields 0 where the divisor is 0, as in task 3.
+ */
+template<MatrixArgument L, MatrixArgument R>
+auto operator/(L&& left, R&& right) {
+    return expression_detail::combine<SafeDivideOp>(left, right);
+}
+
+/**
+ * @brief Element-wise maximum (not named max, which std::max would shadow).
+ */
+template<MatrixArgument L, MatrixArgument R>
+auto elementMax(L&& left, R&& right) {
+    return expression_detail::combine<MaxOp>(left, right);
+}
+
+/**
+ * @brief Computes an expression into result in one pass over its inputs.
+ * Each group of MATRIX_ROW_QUANTUM elements is computed into registers and
+ * then stored, so result may be one of the input matrices itself (but must
+ * not partially overlap one), and the group loop vectorizes. Large results
+ * are computed in bands of rows on sharedThreadPool(), as in transformElements().
+ * @throws invalid_argument if result does not have the shape of the expression
+ */
+template<typename E>
+void evaluateInto(MatrixView result, const MatrixExpression<E>& expression) {
+    const E& source = expression.derived();
+    if (result.rows() != source.rows() || result.cols() != source.cols()) {
+        throw std::invalid_argument("Matrix dimensions do not match");
+    }
+
+    const std::size_t cols = source.cols();
+    elementwise_detail::forEachRowBand(&sharedThreadPool(), source.rows(), cols,
+        [&](std::size_t firstRow, std::size_t lastRow) {
+        for (std::size_t i = firstRow; i < lastRow; ++i) {
+            const auto row = source.row(i);
+            double* out = result[i];
+
+            std::size_t j = 0;
+            for (; j + MATRIX_ROW_QUANTUM <= cols; j += MATRIX_ROW_QUANTUM) {
+                double values[MATRIX_ROW_QUANTUM];
+                for (std::size_t k = 0; k < MATRIX_ROW_QUANTUM; ++k) {
+                    values[k] = row[j + k];
+                }
+                for (std::size_t k = 0; k < MATRIX_ROW_QUANTUM; ++k) {
+                    out[j + k] = values[k];
+                }
+            }
+            for (; j < cols; ++j) {
+                out[j] = row[j];
+            }
+        }
+    });
+}
+
+/**
+ * @brief Computes an expression into a new matrix, the only allocation it makes.
+ * The matrix is left uninitialized, so each band of rows is first touched by
+ * the thread that computes it.
+ */
+template<typename E>
+DynamicMatrix evaluate(const MatrixExpression<E>& expression) {
+    DynamicMatrix result = DynamicMatrix::uninitialized(expression.derived().rows(), expression.derived().cols());
+    evaluateInto(result, expression);
+    return result;
+}
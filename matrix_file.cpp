@@ -0,0 +1,142 @@
+#include "matrix_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+static_assert(sizeof(int) == 4, "INT32 matrix files store int elements directly");
+
+namespace {
+    /**
+     * @brief Returns true if a * b does not overflow size_t.
+     */
+    bool productFits(uint64_t a, uint64_t b) {
+        return a == 0 || b <= numeric_limits<size_t>::max() / a;
+    }
+
+    [[noreturn]] void invalidFile(const string& reason) {
+        throw runtime_error("Invalid binary matrix file: " + reason);
+    }
+}
+
+size_t matrixElementSize(MatrixDataType dataType) {
+    return dataType == MatrixDataType::INT32 ? sizeof(int32_t) : sizeof(double);
+}
+
+bool BinaryMatrixFile::matches(string_view contents) {
+    return contents.size() >= sizeof(MATRIX_FILE_MAGIC)
+        && memcmp(contents.data(), MATRIX_FILE_MAGIC, sizeof(MATRIX_FILE_MAGIC)) == 0;
+}
+
+BinaryMatrixFile::BinaryMatrixFile(string_view contents) : data_(contents.data()) {
+    if (!matches(contents) || contents.size() < sizeof(MatrixFileHeader)) {
+        invalidFile("header missing");
+    }
+    MatrixFileHeader header;
+    memcpy(&header, contents.data(), sizeof(header));
+
+    if (header.version != MATRIX_FILE_VERSION) {
+        invalidFile("unsupported version " + to_string(header.version));
+    }
+    if (header.dataType != MatrixDataType::FLOAT64 && header.dataType != MatrixDataType::INT32) {
+        invalidFile("unknown data type " + to_string(static_cast<uint32_t>(header.dataType)));
+    }
+    const size_t elementSize = matrixElementSize(header.dataType);
+    if (header.cols > header.stride || !productFits(header.stride, elementSize)
+        || !productFits(header.rows, header.stride * elementSize)
+        || header.rows * header.stride * elementSize > header.matrixBytes) {
+        invalidFile("rows do not fit the matrix size");
+    }
+    if (header.dataOffset < sizeof(MatrixFileHeader) || header.dataOffset % elementSize != 0
+        || header.matrixBytes % elementSize != 0) {
+        invalidFile("misaligned data");
+    }
+    if (header.dataOffset > contents.size() || !productFits(header.count, header.matrixBytes)
+        || header.count * header.matrixBytes > contents.size() - header.dataOffset) {
+        invalidFile("file shorter than its header declares");
+    }
+
+    dataType_ = header.dataType;
+    count_ = static_cast<size_t>(header.count);
+    rows_ = static_cast<size_t>(header.rows);
+    cols_ = static_cast<size_t>(header.cols);
+    stride_ = static_cast<size_t>(header.stride);
+    dataOffset_ = static_cast<size_t>(header.dataOffset);
+    matrixBytes_ = static_cast<size_t>(header.matrixBytes);
+}
+
+const void* BinaryMatrixFile::row(size_t index, size_t i) const {
+    if (index >= count_) {
+        throw runtime_error("Binary matrix file holds " + to_string(count_) + " matrices, no matrix "
+            + to_string(index));
+    }
+    return data_ + dataOffset_ + index * matrixBytes_ + i * stride_ * matrixElementSize(dataType_);
+}
+
+ConstMatrixView BinaryMatrixFile::view(size_t index) const {
+    if (dataType_ != MatrixDataType::FLOAT64) {
+        throw runtime_error("Binary matrix file does not hold doubles");
+    }
+    return ConstMatrixView(static_cast<const double*>(row(index, 0)), rows_, cols_, stride_);
+}
+
+void BinaryMatrixFile::read(size_t index, MatrixView destination) const {
+    if (destination.rows() != rows_ || destination.cols() != cols_) {
+        throw runtime_error("Binary matrix file holds " + to_string(rows_) + "x" + to_string(cols_)
+            + " matrices, expected " + to_string(destination.rows()) + "x" + to_string(destination.cols()));
+    }
+    for (size_t i = 0; i < rows_; ++i) {
+        const void* source = row(index, i);
+        if (dataType_ == MatrixDataType::FLOAT64) {
+            memcpy(destination[i], source, cols_ * sizeof(double));
+            continue;
+        }
+        const int32_t* values = static_cast<const int32_t*>(source);
+        double* target = destination[i];
+        for (size_t j = 0; j < cols_; ++j) {
+            target[j] = values[j];
+        }
+    }
+}
+
+void writeBinaryMatrixFile(const string& path, MatrixDataType dataType, size_t count,
+    size_t rows, size_t cols, const function<const void*(size_t m, size_t i)>& row) {
+    const size_t elementSize = matrixElementSize(dataType);
+    const size_t quantum = MATRIX_ALIGNMENT / elementSize;
+    const size_t stride = (cols + quantum - 1) / quantum * quantum;
+    const size_t rowBytes = stride * elementSize;
+
+    MatrixFileHeader header = {};
+    memcpy(header.magic, MATRIX_FILE_MAGIC, sizeof(header.magic));
+    header.version = MATRIX_FILE_VERSION;
+    header.dataType = dataType;
+    header.count = count;
+    header.rows = rows;
+    header.cols = cols;
+    header.stride = stride;
+    header.dataOffset = MATRIX_ALIGNMENT;
+    header.matrixBytes = rows * rowBytes;
+
+    ofstream file(path, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        throw runtime_error("Cannot open output file: " + path);
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    const vector<char> padding(max(rowBytes, MATRIX_ALIGNMENT), 0);
+    file.write(padding.data(), static_cast<streamsize>(MATRIX_ALIGNMENT - sizeof(header)));
+
+    for (size_t m = 0; m < count; ++m) {
+        for (size_t i = 0; i < rows; ++i) {
+            file.write(static_cast<const char*>(row(m, i)), static_cast<streamsize>(cols * elementSize));
+            file.write(padding.data(), static_cast<streamsize>(rowBytes - cols * elementSize));
+        }
+    }
+    if (!file) {
+        throw runtime_error("Error writing binary matrix file: " + path);
+    }
+}
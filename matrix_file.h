@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "dynamic_matrix.h"
+
+/**
+ * @brief Element type of a binary matrix file.
+ */
+enum class MatrixDataType : std::uint32_t {
+    FLOAT64 = 1,    ///< double (task 3)
+    INT32 = 2       ///< 32-bit int (task 5)
+};
+
+// First bytes of every binary matrix file; no text input starts with them
+constexpr char MATRIX_FILE_MAGIC[8] = { 'L', 'A', 'B', 'M', 'A', 'T', 'R', 'X' };
+constexpr std::uint32_t MATRIX_FILE_VERSION = 1;
+
+/**
+ * @brief Header at the start of a binary matrix file, in native byte order.
+ * The file holds count matrices of rows x cols elements of dataType. Matrix m
+ * starts dataOffset + m * matrixBytes bytes into the file and its row i
+ * i * stride elements further. The writer makes dataOffset, matrixBytes and
+ * every row a multiple of MATRIX_ALIGNMENT bytes, the layout of DynamicMatrix,
+ * so a mapped FLOAT64 file is used in place as matrix storage.
+ */
+struct MatrixFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    MatrixDataType dataType;
+    std::uint64_t count;
+    std::uint64_t rows;
+    std::uint64_t cols;
+    std::uint64_t stride;           ///< Elements from one row to the next
+    std::uint64_t dataOffset;       ///< Bytes from the file start to the first matrix
+    std::uint64_t matrixBytes;      ///< Bytes from one matrix to the next
+};
+static_assert(sizeof(MatrixFileHeader) == 64, "MatrixFileHeader must have no padding");
+
+/**
+ * @brief Binary matrix file read in place from its bytes (usually a MappedInputFile).
+ * The header is checked against the file size once; after that the matrices
+ * are read without parsing anything. The bytes must outlive the object and
+ * every view it returns.
+ */
+class BinaryMatrixFile {
+public:
+    /**
+     * @brief Returns true if contents start with MATRIX_FILE_MAGIC.
+     */
+    static bool matches(std::string_view contents);
+
+    /**
+     * @brief Validates the header of a binary matrix file.
+     * @param contents Whole file contents
+     * @throws runtime_error if the header is malformed or the file is shorter than it declares
+     */
+    explicit BinaryMatrixFile(std::string_view contents);
+
+    MatrixDataType dataType() const {
+        return dataType_;
+    }
+
+    std::size_t count() const {
+        return count_;
+    }
+
+    std::size_t rows() const {
+        return rows_;
+    }
+
+    std::size_t cols() const {
+        return cols_;
+    }
+
+    /**
+     * @brief Matrix index of a FLOAT64 file, in place (no copy).
+     * @throws runtime_error for an INT32 file or an index past count()
+     */
+    ConstMatrixView view(std::size_t index) const;
+
+    /**
+     * @brief Row i of matrix index, cols() elements of dataType().
+     * @throws runtime_error if index is past count()
+     */
+    const void* row(std::size_t index, std::size_t i) const;
+
+    /**
+     * @brief Copies matrix index into destination, converting INT32 elements to double.
+     * @throws runtime_error if index is past count() or destination has another shape
+     */
+    void read(std::size_t index, MatrixView destination) const;
+
+private:
+    const char* data_ = nullptr;
+    MatrixDataType dataType_ = MatrixDataType::FLOAT64;
+    std::size_t count_ = 0;
+    std::size_t rows_ = 0;
+    std::size_t cols_ = 0;
+    std::size_t stride_ = 0;
+    std::size_t dataOffset_ = 0;
+    std::size_t matrixBytes_ = 0;
+};
+
+/**
+ * @brief Size in bytes of one element of the given type.
+ */
+std::size_t matrixElementSize(MatrixDataType dataType);
+
+/**
+ * @brief Writes count matrices of one shape as a binary matrix file.
+ * Rows are padded to MATRIX_ALIGNMENT bytes with zeros.
+ * @param path Output file, overwritten
+ * @param dataType Element type of the rows
+ * @param count Number of matrices
+ * @param rows Rows of each matrix
+ * @param cols Columns of each matrix
+ * @param row Returns the cols elements of row i of matrix m
+ * @throws runtime_error if the file cannot be written
+ */
+void writeBinaryMatrixFile(const std::string& path, MatrixDataType dataType, std::size_t count,
+    std::size_t rows, std::size_t cols, const std::function<const void*(std::size_t m, std::size_t i)>& row);
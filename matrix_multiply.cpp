@@ -0,0 +1,390 @@
+#include "matrix_multiply.h"
+#include "cpu_features.h"
+
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#if LAB_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+    // Depth of the packed blocks: one KC x NR sliver of the right panel
+    // (32 KiB at NR = 16) is reread from L1 by every tile of a row block
+    constexpr size_t DEPTH_BLOCK = 256;
+
+    // Rows of left packed at once (MC x KC, 288 KiB, stays in L2); a multiple of every MR
+    constexpr size_t ROW_BLOCK = 144;
+
+    // Columns of right packed at once (KC x NC, 4 MiB, stays in the LLC); a multiple of every NR
+    constexpr size_t COL_BLOCK = 2048;
+
+    // Elements of the largest micro-tile (12 x 16)
+    constexpr size_t MAX_TILE = 192;
+
+    // Products of fewer multiply-adds stay on the calling thread
+    constexpr size_t PARALLEL_MIN_FMAS = size_t(1) << 22;
+
+    /**
+     * @brief Computes one MR x NR tile from kc packed columns of left and rows of right.
+     * tile(i, j) is the sum over p of a[p * MR + i] * b[p * NR + j]; it is
+     * stored to c (row stride ldc), or added to c when accumulate is set.
+     */
+    using TileKernel = void (*)(size_t kc, const double* a, const double* b, double* c, size_t ldc, bool accumulate);
+
+    struct MicroKernel {
+        TileKernel tile;
+        size_t rows;    ///< MR, rows of left per packed sliver
+        size_t cols;    ///< NR, columns of right per packed sliver
+    };
+
+    void tileScalar(size_t kc, const double* a, const double* b, double* c, size_t ldc, bool accumulate) {
+        constexpr size_t MR = 4;
+        constexpr size_t NR = 4;
+        double sum[MR][NR] = {};
+        for (size_t p = 0; p < kc; ++p) {
+            LAB_UNROLL
+            for (size_t i = 0; i < MR; ++i) {
+                LAB_UNROLL
+                for (size_t j = 0; j < NR; ++j) {
+                    sum[i][j] += a[p * MR + i] * b[p * NR + j];
+                }
+            }
+        }
+        for (size_t i = 0; i < MR; ++i) {
+            for (size_t j = 0; j < NR; ++j) {
+                c[i * ldc + j] = accumulate ? c[i * ldc + j] + sum[i][j] : sum[i][j];
+            }
+        }
+    }
+
+#if LAB_X86
+    void tileSse2(size_t kc, const double* a, const double* b, double* c, size_t ldc, bool accumulate) {
+        constexpr size_t MR = 4;
+        constexpr size_t VECTORS = 2;   // NR = 4
+        __m128d sum[MR][VECTORS];
+        LAB_UNROLL
+        for (size_t i = 0; i < MR; ++i) {
+            LAB_UNROLL
+            for (size_t v = 0; v < VECTORS; ++v) {
+                sum[i][v] = _mm_setzero_pd();
+            }
+        }
+        for (size_t p = 0; p < kc; ++p) {
+            const __m128d row0 = _mm_loadu_pd(b + p * 4);
+            const __m128d row1 = _mm_loadu_pd(b + p * 4 + 2);
+            LAB_UNROLL
+            for (size_t i = 0; i < MR; ++i) {
+                const __m128d x = _mm_set1_pd(a[p * MR + i]);
+                sum[i][0] = _mm_add_pd(sum[i][0], _mm_mul_pd(x, row0));
+                sum[i][1] = _mm_add_pd(sum[i][1], _mm_mul_pd(x, row1));
+            }
+        }
+        LAB_UNROLL
+        for (size_t i = 0; i < MR; ++i) {
+            LAB_UNROLL
+            for (size_t v = 0; v < VECTORS; ++v) {
+                double* out = c + i * ldc + v * 2;
+                _mm_storeu_pd(out, accumulate ? _mm_add_pd(_mm_loadu_pd(out), sum[i][v]) : sum[i][v]);
+            }
+        }
+    }
+
+    LAB_TARGET("avx2,fma")
+    void tileAvx2(size_t kc, const double* a, const double* b, double* c, size_t ldc, bool accumulate) {
+        constexpr size_t MR = 6;
+        constexpr size_t VECTORS = 2;   // NR = 8
+        __m256d sum[MR][VECTORS];
+        LAB_UNROLL
+        for (size_t i = 0; i < MR; ++i) {
+            LAB_UNROLL
+            for (size_t v = 0; v < VECTORS; ++v) {
+                sum[i][v] = _mm256_setzero_pd();
+            }
+        }
+        for (size_t p = 0; p < kc; ++p) {
+            const __m256d row0 = _mm256_loadu_pd(b + p * 8);
+            const __m256d row1 = _mm256_loadu_pd(b + p * 8 + 4);
+            LAB_UNROLL
+            for (size_t i = 0; i < MR; ++i) {
+                const __m256d x = _mm256_broadcast_sd(a + p * MR + i);
+                sum[i][0] = _mm256_fmadd_pd(x, row0, sum[i][0]);
+                sum[i][1] = _mm256_fmadd_pd(x, row1, sum[i][1]);
+            }
+        }
+        LAB_UNROLL
+        for (size_t i = 0; i < MR; ++i) {
+            LAB_UNROLL
+            for (size_t v = 0; v < VECTORS; ++v) {
+                double* out = c + i * ldc + v * 4;
+                _mm256_storeu_pd(out, accumulate ? _mm256_add_pd(_mm256_loadu_pd(out), sum[i][v]) : sum[i][v]);
+            }
+        }
+    }
+
+    LAB_TARGET("avx512f")
+    void tileAvx512(size_t kc, const double* a, const double* b, double* c, size_t ldc, bool accumulate) {
+        constexpr size_t MR = 12;
+        constexpr size_t VECTORS = 2;   // NR = 16; 24 of the 32 registers accumulate
+        __m512d sum[MR][VECTORS];
+        LAB_UNROLL
+        for (size_t i = 0; i < MR; ++i) {
+            LAB_UNROLL
+            for (size_t v = 0; v < VECTORS; ++v) {
+                sum[i][v] = _mm512_setzero_pd();
+            }
+        }
+        for (size_t p = 0; p < kc; ++p) {
+            const __m512d row0 = _mm512_loadu_pd(b + p * 16);
+            const __m512d row1 = _mm512_loadu_pd(b + p * 16 + 8);
+            LAB_UNROLL
+            for (size_t i = 0; i < MR; ++i) {
+                const __m512d x = _mm512_set1_pd(a[p * MR + i]);
+                sum[i][0] = _mm512_fmadd_pd(x, row0, sum[i][0]);
+                sum[i][1] = _mm512_fmadd_pd(x, row1, sum[i][1]);
+            }
+        }
+        LAB_UNROLL
+        for (size_t i = 0; i < MR; ++i) {
+            LAB_UNROLL
+            for (size_t v = 0; v < VECTORS; ++v) {
+                double* out = c + i * ldc + v * 8;
+                _mm512_storeu_pd(out, accumulate ? _mm512_add_pd(_mm512_loadu_pd(out), sum[i][v]) : sum[i][v]);
+            }
+        }
+    }
+#endif
+
+    MicroKernel microKernel() {
+#if LAB_X86
+        switch (simdLevel()) {
+        case SimdLevel::AVX512:
+            return { tileAvx512, 12, 16 };
+        case SimdLevel::AVX2:
+            return { tileAvx2, 6, 8 };
+        case SimdLevel::SSE2:
+            return { tileSse2, 4, 4 };
+        default:
+            break;
+        }
+#endif
+        return { tileScalar, 4, 4 };
+    }
+
+    size_t roundUp(size_t value, size_t multiple) {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    /**
+     * @brief Right operand: element (p, j) is view(p, j), or view(j, p) when transposed.
+     */
+    struct RightOperand {
+        ConstMatrixView view;
+        bool transposed;
+
+        size_t depth() const {
+            return transposed ? view.cols() : view.rows();
+        }
+
+        size_t cols() const {
+            return transposed ? view.rows() : view.cols();
+        }
+    };
+
+    /**
+     * @brief Packs rows [row0, row0 + rowCount) x depth [p0, p0 + kc) of left into slivers of mr rows.
+     * Sliver s holds element (row0 + s * mr + i, p0 + p) at s * mr * kc + p * mr + i;
+     * rows past rowCount are zero.
+     */
+    void packLeft(ConstMatrixView left, size_t row0, size_t rowCount, size_t p0, size_t kc, size_t mr, double* packed) {
+        for (size_t s = 0; s < rowCount; s += mr) {
+            for (size_t i = 0; i < mr; ++i) {
+                if (s + i < rowCount) {
+                    const double* source = left[row0 + s + i] + p0;
+                    for (size_t p = 0; p < kc; ++p) {
+                        packed[p * mr + i] = source[p];
+                    }
+                }
+                else {
+                    for (size_t p = 0; p < kc; ++p) {
+                        packed[p * mr + i] = 0.0;
+                    }
+                }
+            }
+            packed += mr * kc;
+        }
+    }
+
+    /**
+     * @brief Packs depth [p0, p0 + kc) x columns [col0, col0 + colCount) of right into slivers of nr columns.
+     * Sliver s holds element (p0 + p, col0 + s * nr + j) at s * nr * kc + p * nr + j;
+     * columns past colCount are zero.
+     */
+    void packRight(const RightOperand& right, size_t p0, size_t kc, size_t col0, size_t colCount, size_t nr, double* packed) {
+        for (size_t s = 0; s < colCount; s += nr) {
+            const size_t cols = min(nr, colCount - s);
+            if (right.transposed) {
+                // Column j of the operand is row j of the view, contiguous in p
+                for (size_t j = 0; j < nr; ++j) {
+                    const double* source = (j < cols) ? right.view[col0 + s + j] + p0 : nullptr;
+                    for (size_t p = 0; p < kc; ++p) {
+                        packed[p * nr + j] = source ? source[p] : 0.0;
+                    }
+                }
+            }
+            else {
+                for (size_t p = 0; p < kc; ++p) {
+                    const double* source = right.view[p0 + p] + col0 + s;
+                    copy_n(source, cols, packed + p * nr);
+                    fill_n(packed + p * nr + cols, nr - cols, 0.0);
+                }
+            }
+            packed += nr * kc;
+        }
+    }
+
+    /**
+     * @brief Computes (or accumulates) product rows [row0, row0 + rowCount) x columns
+     * [col0, col0 + colCount) from a packed block of left and a packed panel of right.
+     * Tiles cut by the edge of the product are computed into a buffer and copied.
+     */
+    void multiplyBlock(const MicroKernel& kernel, const double* packedLeft, const double* packedRight, size_t kc,
+        MatrixView product, size_t row0, size_t rowCount, size_t col0, size_t colCount, bool accumulate) {
+        alignas(MATRIX_ALIGNMENT) double edge[MAX_TILE];
+        const size_t stride = product.stride();
+        for (size_t j = 0; j < colCount; j += kernel.cols) {
+            const size_t cols = min(kernel.cols, colCount - j);
+            const double* b = packedRight + j * kc;
+            for (size_t i = 0; i < rowCount; i += kernel.rows) {
+                const size_t rows = min(kernel.rows, rowCount - i);
+                const double* a = packedLeft + i * kc;
+                double* c = product[row0 + i] + col0 + j;
+                if (rows == kernel.rows && cols == kernel.cols) {
+                    kernel.tile(kc, a, b, c, stride, accumulate);
+                    continue;
+                }
+                kernel.tile(kc, a, b, edge, kernel.cols, false);
+                for (size_t r = 0; r < rows; ++r) {
+                    for (size_t q = 0; q < cols; ++q) {
+                        const double value = edge[r * kernel.cols + q];
+                        c[r * stride + q] = accumulate ? c[r * stride + q] + value : value;
+                    }
+                }
+            }
+        }
+    }
+
+    void checkShapes(ConstMatrixView left, const RightOperand& right, ConstMatrixView product) {
+        if (left.cols() != right.depth() || product.rows() != left.rows() || product.cols() != right.cols()) {
+            throw invalid_argument("Matrix dimensions do not match for multiplication");
+        }
+        if (viewsOverlap(product, left) || viewsOverlap(product, right.view)) {
+            throw invalid_argument("Matrix product overlaps an operand");
+        }
+    }
+
+    /**
+     * @brief Runs function(0) .. function(count - 1), on pool if there is one.
+     */
+    template<typename F>
+    void forEachTask(ThreadPool* pool, size_t count, const F& function) {
+        if (pool == nullptr || count < 2) {
+            for (size_t task = 0; task < count; ++task) {
+                function(task);
+            }
+            return;
+        }
+        vector<future<void>> pending;
+        pending.reserve(count);
+        for (size_t task = 0; task < count; ++task) {
+            pending.push_back(pool->submit([&function, task]() { function(task); }));
+        }
+        ThreadPool::waitAll(pending);
+    }
+
+    /**
+     * @brief The blocked product; pool == nullptr runs it on the calling thread.
+     * For every panel of right (NC columns x KC depth, packed once, in
+     * parallel by slivers), the row blocks of left are packed and multiplied
+     * as independent tasks: each writes its own rows of product.
+     */
+    void multiplyBlocked(ThreadPool* pool, ConstMatrixView left, const RightOperand& right, MatrixView product) {
+        checkShapes(left, right, product);
+        const size_t m = left.rows();
+        const size_t k = left.cols();
+        const size_t n = right.cols();
+        if (m == 0 || n == 0) {
+            return;
+        }
+        if (k == 0) {
+            for (size_t i = 0; i < m; ++i) {
+                fill_n(product[i], n, 0.0);
+            }
+            return;
+        }
+
+        const MicroKernel kernel = microKernel();
+        const size_t workers = (pool != nullptr) ? pool->size() : 1;
+
+        // Smaller row blocks when there are too few to give every worker one
+        const size_t rowBlock = min(ROW_BLOCK, roundUp((m + workers - 1) / workers, kernel.rows));
+        const size_t rowBlocks = (m + rowBlock - 1) / rowBlock;
+
+        vector<double> packedRight(roundUp(min(n, COL_BLOCK), kernel.cols) * DEPTH_BLOCK);
+        for (size_t col0 = 0; col0 < n; col0 += COL_BLOCK) {
+            const size_t colCount = min(COL_BLOCK, n - col0);
+            const size_t slivers = (colCount + kernel.cols - 1) / kernel.cols;
+            const size_t sliversPerTask = (slivers + workers - 1) / workers;
+
+            for (size_t p0 = 0; p0 < k; p0 += DEPTH_BLOCK) {
+                const size_t kc = min(DEPTH_BLOCK, k - p0);
+
+                forEachTask(pool, (slivers + sliversPerTask - 1) / sliversPerTask, [&](size_t task) {
+                    const size_t first = task * sliversPerTask * kernel.cols;
+                    const size_t count = min(colCount - first, sliversPerTask * kernel.cols);
+                    packRight(right, p0, kc, col0 + first, count, kernel.cols, packedRight.data() + first * kc);
+                });
+
+                forEachTask(pool, rowBlocks, [&](size_t task) {
+                    const size_t row0 = task * rowBlock;
+                    const size_t rowCount = min(rowBlock, m - row0);
+
+                    // Reused across calls: a fresh block this size would be
+                    // mapped and page-faulted again every time
+                    thread_local vector<double> packedLeft;
+                    packedLeft.resize(roundUp(rowCount, kernel.rows) * kc);
+                    packLeft(left, row0, rowCount, p0, kc, kernel.rows, packedLeft.data());
+                    multiplyBlock(kernel, packedLeft.data(), packedRight.data(), kc,
+                        product, row0, rowCount, col0, colCount, p0 != 0);
+                });
+            }
+        }
+    }
+
+    ThreadPool* automaticPool(ConstMatrixView left, const RightOperand& right) {
+        const size_t fmas = left.rows() * left.cols() * right.cols();
+        return (fmas >= PARALLEL_MIN_FMAS && sharedThreadPool().size() > 1) ? &sharedThreadPool() : nullptr;
+    }
+}
+
+void multiplyInto(ConstMatrixView left, ConstMatrixView right, MatrixView product) {
+    const RightOperand operand{ right, false };
+    multiplyBlocked(automaticPool(left, operand), left, operand, product);
+}
+
+void multiplyInto(ThreadPool& pool, ConstMatrixView left, ConstMatrixView right, MatrixView product) {
+    multiplyBlocked(&pool, left, RightOperand{ right, false }, product);
+}
+
+void multiplyTransposedInto(ConstMatrixView left, ConstMatrixView right, MatrixView product) {
+    const RightOperand operand{ right, true };
+    multiplyBlocked(automaticPool(left, operand), left, operand, product);
+}
+
+void multiplyTransposedInto(ThreadPool& pool, ConstMatrixView left, ConstMatrixView right, MatrixView product) {
+    multiplyBlocked(&pool, left, RightOperand{ right, true }, product);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "dynamic_matrix.h"
+#include "thread_pool.h"
+
+/**
+ * @brief Matrix product: product = left * right (m x k times k x n gives m x n).
+ * Blocked like a BLAS GEMM: panels of right are packed to stay in the
+ * last-level cache, blocks of left to stay in L2, and a register micro-kernel
+ * for the current SIMD level (up to 12 x 16 with AVX-512 FMA) computes each
+ * small tile of product from packed data streamed through L1. Products large
+ * enough to pay for the threads run on sharedThreadPool().
+ *
+ * Sums are taken in a different order than a naive loop, and with FMA above
+ * SSE2, so results may differ from it in the last bits.
+ * @throws invalid_argument if the shapes do not match or product overlaps an operand
+ */
+void multiplyInto(ConstMatrixView left, ConstMatrixView right, MatrixView product);
+
+/**
+ * @brief Same as multiplyInto(left, right, product), with the row blocks always on pool.
+ * @param pool Pool to run on
+ */
+void multiplyInto(ThreadPool& pool, ConstMatrixView left, ConstMatrixView right, MatrixView product);
+
+/**
+ * @brief product = left * transpose(right) (m x k times (n x k)^T gives m x n).
+ * The transpose is never formed: packing reads right by rows instead of
+ * by columns, so it costs the same as multiplyInto().
+ * @throws invalid_argument if the shapes do not match or product overlaps an operand
+ */
+void multiplyTransposedInto(ConstMatrixView left, ConstMatrixView right, MatrixView product);
+
+/**
+ * @brief Same as multiplyTransposedInto(left, right, product), with the row blocks always on pool.
+ * @param pool Pool to run on
+ */
+void multiplyTransposedInto(ThreadPool& pool, ConstMatrixView left, ConstMatrixView right, MatrixView product);
@@ -0,0 +1,140 @@
+#include "matrix_text.h"
+#include "text_scanner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <future>
+
+using namespace std;
+
+namespace {
+    // Chunks of text and bands of rows per pool worker, so uneven lines still balance
+    constexpr size_t TASKS_PER_WORKER = 4;
+
+    /**
+     * @brief Runs body(0) .. body(count - 1) on pool, or on the calling thread without one.
+     */
+    void forEachTask(ThreadPool* pool, size_t count, const function<void(size_t)>& body) {
+        if (pool == nullptr || count < 2) {
+            for (size_t task = 0; task < count; ++task) {
+                body(task);
+            }
+            return;
+        }
+        vector<future<void>> pending;
+        pending.reserve(count);
+        for (size_t task = 0; task < count; ++task) {
+            pending.push_back(pool->submit([&body, task]() { body(task); }));
+        }
+        ThreadPool::waitAll(pending);
+    }
+
+    bool isBlank(string_view line) {
+        return line.find_first_not_of(" \t\r\v\f") == string_view::npos;
+    }
+
+    /**
+     * @brief Appends the non-blank lines that start in text[begin, end).
+     * A line running into the range from before begin belongs to the previous chunk.
+     */
+    void findLines(string_view text, size_t begin, size_t end, vector<string_view>& lines) {
+        const char* data = text.data();
+        auto lineEnd = [&](size_t from) {
+            const void* newline = memchr(data + from, '\n', text.size() - from);
+            return newline != nullptr ? static_cast<size_t>(static_cast<const char*>(newline) - data) : text.size();
+        };
+
+        size_t position = begin;
+        if (position > 0 && data[position - 1] != '\n') {
+            position = lineEnd(position) + 1;
+        }
+        while (position < end) {
+            const size_t last = lineEnd(position);
+            const string_view line(data + position, last - position);
+            if (!isBlank(line)) {
+                lines.push_back(line);
+            }
+            position = last + 1;
+        }
+    }
+
+    /**
+     * @brief Parses exactly cols values from a line holding nothing else.
+     */
+    bool parseRow(string_view line, double* row, size_t cols) {
+        TextScanner scanner(line);
+        for (size_t j = 0; j < cols; ++j) {
+            if (!scanner.next(row[j])) {
+                return false;
+            }
+        }
+        return scanner.atEnd();
+    }
+
+    bool parseRowsOn(ThreadPool* pool, string_view text, const vector<MatrixView>& matrices) {
+        size_t totalRows = 0;
+        for (const MatrixView& matrix : matrices) {
+            totalRows += matrix.rows();
+        }
+        if (totalRows == 0) {
+            return true;
+        }
+
+        // Row boundaries: every chunk collects its own lines, then they are joined in order
+        const size_t tasks = pool != nullptr ? max<size_t>(1, pool->size() * TASKS_PER_WORKER) : 1;
+        const size_t chunkSize = (text.size() + tasks - 1) / tasks;
+        vector<vector<string_view>> chunkLines(tasks);
+        forEachTask(pool, tasks, [&](size_t chunk) {
+            const size_t begin = min(text.size(), chunk * chunkSize);
+            findLines(text, begin, min(text.size(), begin + chunkSize), chunkLines[chunk]);
+        });
+
+        vector<string_view> lines;
+        lines.reserve(totalRows);
+        for (const auto& found : chunkLines) {
+            const size_t take = min(found.size(), totalRows - lines.size());
+            lines.insert(lines.end(), found.begin(), found.begin() + static_cast<ptrdiff_t>(take));
+        }
+        if (lines.size() < totalRows) {
+            return false;
+        }
+
+        // Values: each band parses its lines into the rows they stand for
+        atomic<bool> parsed{ true };
+        const size_t rowsPerBand = (totalRows + tasks - 1) / tasks;
+        forEachTask(pool, (totalRows + rowsPerBand - 1) / rowsPerBand, [&](size_t band) {
+            const size_t first = band * rowsPerBand;
+            const size_t last = min(totalRows, first + rowsPerBand);
+
+            size_t m = 0, i = first;
+            while (i >= matrices[m].rows()) {
+                i -= matrices[m++].rows();
+            }
+            for (size_t r = first; r < last; ++r, ++i) {
+                while (i == matrices[m].rows()) {
+                    i = 0;
+                    ++m;
+                }
+                if (!parsed.load(memory_order_relaxed) || !parseRow(lines[r], matrices[m][i], matrices[m].cols())) {
+                    parsed.store(false, memory_order_relaxed);
+                    return;
+                }
+            }
+        });
+        return parsed.load();
+    }
+}
+
+bool parseMatrixRows(string_view text, const vector<MatrixView>& matrices) {
+    ThreadPool& pool = sharedThreadPool();
+    if (text.size() >= PARALLEL_PARSE_MIN_BYTES && pool.size() > 1) {
+        return parseRowsOn(&pool, text, matrices);
+    }
+    return parseRowsOn(nullptr, text, matrices);
+}
+
+bool parseMatrixRows(ThreadPool& pool, string_view text, const vector<MatrixView>& matrices) {
+    return parseRowsOn(&pool, text, matrices);
+}
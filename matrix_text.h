@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "dynamic_matrix.h"
+#include "thread_pool.h"
+
+// Text shorter than this is parsed on the calling thread
+constexpr std::size_t PARALLEL_PARSE_MIN_BYTES = 1u << 20;
+
+/**
+ * @brief Parses matrices written one row per line, using all cores.
+ * The text is cut into chunks at line breaks. Each worker finds the starts of
+ * the non-blank lines in its chunk. The r-th such line is then row r of the
+ * matrices, taken in order. Bands of rows are parsed with std::from_chars
+ * (TextScanner) straight into the matrix storage.
+ *
+ * On success the values equal what a TextScanner reading the same text
+ * token by token would give. Any other layout, such as a row split over
+ * lines, two rows on one line, a malformed value or too few lines, returns
+ * false. The matrices may then be partly written; the caller falls back to
+ * the sequential reader, which accepts every layout and reports the error.
+ * @param text Matrix rows; anything after the last row is ignored
+ * @param matrices Matrices to fill, in the order of their rows in text
+ * @return true if every row was on a line of its own and parsed
+ */
+bool parseMatrixRows(std::string_view text, const std::vector<MatrixView>& matrices);
+
+/**
+ * @brief Same as parseMatrixRows(text, matrices), always split over pool.
+ * @param pool Pool to run on
+ */
+bool parseMatrixRows(ThreadPool& pool, std::string_view text, const std::vector<MatrixView>& matrices);
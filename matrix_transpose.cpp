@@ -0,0 +1,275 @@
+#include "matrix_transpose.h"
+#include "cpu_features.h"
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if LAB_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+    // Bands of tiles per pool worker, so uneven bands still balance
+    constexpr size_t BANDS_PER_WORKER = 4;
+
+    /**
+     * @brief Transposes a size x size block: source row r becomes destination column r.
+     */
+    using BlockKernel = void (*)(const double* source, size_t sourceStride, double* destination, size_t destinationStride);
+
+    struct Kernel {
+        BlockKernel block;
+        size_t size;
+    };
+
+    void blockScalar(const double* source, size_t sourceStride, double* destination, size_t destinationStride) {
+        for (size_t r = 0; r < 4; ++r) {
+            for (size_t c = 0; c < 4; ++c) {
+                destination[c * destinationStride + r] = source[r * sourceStride + c];
+            }
+        }
+    }
+
+#if LAB_X86
+    void blockSse2(const double* source, size_t sourceStride, double* destination, size_t destinationStride) {
+        const __m128d row0 = _mm_loadu_pd(source);
+        const __m128d row1 = _mm_loadu_pd(source + sourceStride);
+        _mm_storeu_pd(destination, _mm_unpacklo_pd(row0, row1));
+        _mm_storeu_pd(destination + destinationStride, _mm_unpackhi_pd(row0, row1));
+    }
+
+    LAB_TARGET("avx2")
+    void blockAvx2(const double* source, size_t sourceStride, double* destination, size_t destinationStride) {
+        const __m256d row0 = _mm256_loadu_pd(source);
+        const __m256d row1 = _mm256_loadu_pd(source + sourceStride);
+        const __m256d row2 = _mm256_loadu_pd(source + 2 * sourceStride);
+        const __m256d row3 = _mm256_loadu_pd(source + 3 * sourceStride);
+
+        // Pairs (r0[k], r1[k]) and (r2[k], r3[k]) for even and odd k, then 128-bit halves recombined
+        const __m256d even01 = _mm256_unpacklo_pd(row0, row1);
+        const __m256d odd01 = _mm256_unpackhi_pd(row0, row1);
+        const __m256d even23 = _mm256_unpacklo_pd(row2, row3);
+        const __m256d odd23 = _mm256_unpackhi_pd(row2, row3);
+
+        _mm256_storeu_pd(destination, _mm256_permute2f128_pd(even01, even23, 0x20));
+        _mm256_storeu_pd(destination + destinationStride, _mm256_permute2f128_pd(odd01, odd23, 0x20));
+        _mm256_storeu_pd(destination + 2 * destinationStride, _mm256_permute2f128_pd(even01, even23, 0x31));
+        _mm256_storeu_pd(destination + 3 * destinationStride, _mm256_permute2f128_pd(odd01, odd23, 0x31));
+    }
+
+    LAB_TARGET("avx512f")
+    void blockAvx512(const double* source, size_t sourceStride, double* destination, size_t destinationStride) {
+        __m512d rows[8];
+        for (size_t r = 0; r < 8; ++r) {
+            rows[r] = _mm512_loadu_pd(source + r * sourceStride);
+        }
+
+        // Stage 1: pairs of rows interleaved, (r[2p][k], r[2p+1][k]) for even and odd k
+        // (as unpacklo/unpackhi, which GCC 12 flags with a false -Wuninitialized)
+        const __m512i evenElements = _mm512_set_epi64(14, 6, 12, 4, 10, 2, 8, 0);
+        const __m512i oddElements = _mm512_set_epi64(15, 7, 13, 5, 11, 3, 9, 1);
+        __m512d pairs[8];
+        for (size_t p = 0; p < 4; ++p) {
+            pairs[2 * p] = _mm512_permutex2var_pd(rows[2 * p], evenElements, rows[2 * p + 1]);
+            pairs[2 * p + 1] = _mm512_permutex2var_pd(rows[2 * p], oddElements, rows[2 * p + 1]);
+        }
+
+        // Stage 2: columns k and k + 4 of four rows; stage 3: all eight rows of column k
+        const __m512i lowPairs = _mm512_set_epi64(13, 12, 5, 4, 9, 8, 1, 0);
+        const __m512i highPairs = _mm512_set_epi64(15, 14, 7, 6, 11, 10, 3, 2);
+        const __m512i lowHalves = _mm512_set_epi64(11, 10, 9, 8, 3, 2, 1, 0);
+        const __m512i highHalves = _mm512_set_epi64(15, 14, 13, 12, 7, 6, 5, 4);
+
+        __m512d quads[8];
+        for (size_t h = 0; h < 2; ++h) {
+            const __m512d even = pairs[4 * h], odd = pairs[4 * h + 1];
+            const __m512d nextEven = pairs[4 * h + 2], nextOdd = pairs[4 * h + 3];
+            quads[4 * h] = _mm512_permutex2var_pd(even, lowPairs, nextEven);        // columns 0, 4
+            quads[4 * h + 1] = _mm512_permutex2var_pd(odd, lowPairs, nextOdd);      // columns 1, 5
+            quads[4 * h + 2] = _mm512_permutex2var_pd(even, highPairs, nextEven);   // columns 2, 6
+            quads[4 * h + 3] = _mm512_permutex2var_pd(odd, highPairs, nextOdd);     // columns 3, 7
+        }
+
+        for (size_t c = 0; c < 4; ++c) {
+            _mm512_storeu_pd(destination + c * destinationStride,
+                _mm512_permutex2var_pd(quads[c], lowHalves, quads[c + 4]));
+            _mm512_storeu_pd(destination + (c + 4) * destinationStride,
+                _mm512_permutex2var_pd(quads[c], highHalves, quads[c + 4]));
+        }
+    }
+#endif
+
+    Kernel blockKernel() {
+#if LAB_X86
+        switch (simdLevel()) {
+        case SimdLevel::AVX512:
+            return { blockAvx512, 8 };
+        case SimdLevel::AVX2:
+            return { blockAvx2, 4 };
+        case SimdLevel::SSE2:
+            return { blockSse2, 2 };
+        default:
+            break;
+        }
+#endif
+        return { blockScalar, 4 };
+    }
+
+    /**
+     * @brief Transposes source rows [rowBegin, rowEnd) x columns [colBegin, colEnd).
+     * Full kernel blocks go through the micro-kernel, the ragged edges element by element.
+     */
+    void transposeTile(const Kernel& kernel, ConstMatrixView source, MatrixView destination,
+        size_t rowBegin, size_t rowEnd, size_t colBegin, size_t colEnd) {
+        const size_t size = kernel.size;
+        size_t i = rowBegin;
+        for (; i + size <= rowEnd; i += size) {
+            size_t j = colBegin;
+            for (; j + size <= colEnd; j += size) {
+                kernel.block(source[i] + j, source.stride(), destination[j] + i, destination.stride());
+            }
+            for (; j < colEnd; ++j) {
+                for (size_t r = i; r < i + size; ++r) {
+                    destination[j][r] = source[r][j];
+                }
+            }
+        }
+        for (; i < rowEnd; ++i) {
+            for (size_t j = colBegin; j < colEnd; ++j) {
+                destination[j][i] = source[i][j];
+            }
+        }
+    }
+
+    /**
+     * @brief Transposes source columns [colBegin, colEnd), i.e. destination rows, tile by tile.
+     */
+    void transposeBand(const Kernel& kernel, ConstMatrixView source, MatrixView destination,
+        size_t colBegin, size_t colEnd) {
+        for (size_t j = colBegin; j < colEnd; j += TRANSPOSE_TILE) {
+            const size_t tileEnd = min(colEnd, j + TRANSPOSE_TILE);
+            for (size_t i = 0; i < source.rows(); i += TRANSPOSE_TILE) {
+                transposeTile(kernel, source, destination, i, min(source.rows(), i + TRANSPOSE_TILE), j, tileEnd);
+            }
+        }
+    }
+
+    void checkShapes(ConstMatrixView source, ConstMatrixView destination) {
+        if (destination.rows() != source.cols() || destination.cols() != source.rows()) {
+            throw invalid_argument("Matrix dimensions do not match for transposition");
+        }
+        if (viewsOverlap(source, destination)) {
+            throw invalid_argument("Transposition source and destination overlap");
+        }
+    }
+
+    /**
+     * @brief In-place transposition of a square matrix: diagonal tiles are
+     * transposed in place and each tile above the diagonal is swapped with its mirror.
+     */
+    void transposeSquare(DynamicMatrix& matrix) {
+        const size_t n = matrix.rows();
+        for (size_t ib = 0; ib < n; ib += TRANSPOSE_TILE) {
+            const size_t iEnd = min(n, ib + TRANSPOSE_TILE);
+            for (size_t jb = ib; jb < n; jb += TRANSPOSE_TILE) {
+                const size_t jEnd = min(n, jb + TRANSPOSE_TILE);
+                for (size_t i = ib; i < iEnd; ++i) {
+                    double* row = matrix[i];
+                    for (size_t j = (jb == ib) ? i + 1 : jb; j < jEnd; ++j) {
+                        swap(row[j], matrix[j][i]);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief In-place transposition of a dense rows x cols array into cols x rows.
+     * The element at k = i * cols + j belongs at j * rows + i; each permutation
+     * cycle is followed once, with one bit per element marking finished positions.
+     */
+    void transposeDense(double* data, size_t rows, size_t cols) {
+        const size_t count = rows * cols;
+        vector<bool> placed(count, false);
+        for (size_t start = 0; start < count; ++start) {
+            if (placed[start]) {
+                continue;
+            }
+            double carried = data[start];
+            size_t position = start;
+            do {
+                const size_t target = (position % cols) * rows + position / cols;
+                swap(carried, data[target]);
+                placed[target] = true;
+                position = target;
+            } while (position != start);
+        }
+    }
+}
+
+void transposeInto(ConstMatrixView source, MatrixView destination) {
+    checkShapes(source, destination);
+    const size_t bytes = 2 * source.rows() * source.cols() * sizeof(double);
+    if (bytes > lastLevelCacheBytes() && sharedThreadPool().size() > 1) {
+        transposeInto(sharedThreadPool(), source, destination);
+        return;
+    }
+    transposeBand(blockKernel(), source, destination, 0, source.cols());
+}
+
+void transposeInto(ThreadPool& pool, ConstMatrixView source, MatrixView destination) {
+    checkShapes(source, destination);
+    const Kernel kernel = blockKernel();
+
+    // Bands are whole tiles of destination rows, so no two tasks write the same cache line
+    const size_t tiles = (source.cols() + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+    const size_t bands = max<size_t>(1, min(tiles, pool.size() * BANDS_PER_WORKER));
+    const size_t tilesPerBand = (tiles + bands - 1) / max<size_t>(1, bands);
+
+    vector<future<void>> pending;
+    for (size_t tile = 0; tile < tiles; tile += tilesPerBand) {
+        const size_t colBegin = tile * TRANSPOSE_TILE;
+        const size_t colEnd = min(source.cols(), (tile + tilesPerBand) * TRANSPOSE_TILE);
+        pending.push_back(pool.submit([&kernel, source, destination, colBegin, colEnd]() {
+            transposeBand(kernel, source, destination, colBegin, colEnd);
+        }));
+    }
+    ThreadPool::waitAll(pending);
+}
+
+void transposeInPlace(DynamicMatrix& matrix) {
+    const size_t rows = matrix.rows();
+    const size_t cols = matrix.cols();
+    if (rows == cols) {
+        transposeSquare(matrix);
+        return;
+    }
+    if (cols * DynamicMatrix::paddedStride(rows) > matrix.capacity()) {
+        DynamicMatrix transposed(cols, rows);
+        transposeInto(matrix, transposed);
+        matrix = move(transposed);
+        return;
+    }
+
+    // Pack the rows densely (moving left, first row first), permute, then
+    // spread the new rows to the padded stride (moving right, last row first)
+    double* data = matrix.data();
+    const size_t stride = matrix.stride();
+    for (size_t i = 1; i < rows; ++i) {
+        memmove(data + i * cols, data + i * stride, cols * sizeof(double));
+    }
+
+    transposeDense(data, rows, cols);
+
+    matrix.reshapeInPlace(cols, rows);
+    const size_t newStride = matrix.stride();
+    for (size_t i = cols; i-- > 1;) {
+        memmove(data + i * newStride, data + i * rows, rows * sizeof(double));
+    }
+}
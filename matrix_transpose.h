@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+
+#include "dynamic_matrix.h"
+#include "thread_pool.h"
+
+// Side of the square tiles the transposition walks; a source and a destination
+// tile of doubles (2 x 8 KiB) stay in the L1 cache together
+constexpr std::size_t TRANSPOSE_TILE = 32;
+
+/**
+ * @brief Writes the transpose of source (rows x cols) into destination (cols x rows).
+ * The matrix is walked in TRANSPOSE_TILE x TRANSPOSE_TILE tiles so both the
+ * reads and the strided writes stay in cache, and every tile is transposed
+ * by a register micro-kernel for the current SIMD level (2x2 SSE2, 4x4 AVX2,
+ * 8x8 AVX-512). When source and destination together exceed the last-level
+ * cache, bands of tiles run on sharedThreadPool().
+ * @throws invalid_argument if destination does not have the transposed shape
+ *         or overlaps source
+ */
+void transposeInto(ConstMatrixView source, MatrixView destination);
+
+/**
+ * @brief Same as transposeInto(source, destination), always with bands of tiles on pool.
+ * @param pool Pool to run on
+ */
+void transposeInto(ThreadPool& pool, ConstMatrixView source, MatrixView destination);
+
+/**
+ * @brief Transposes a matrix within its own storage.
+ * Square matrices swap mirrored tiles. Other shapes are packed densely,
+ * permuted by following the cycles of the transposition (one bit of
+ * bookkeeping per element instead of a second matrix) and spread back to
+ * the padded stride. If the transposed padded layout does not fit the current
+ * allocation, the matrix is transposed into a new one instead.
+ */
+void transposeInPlace(DynamicMatrix& matrix);
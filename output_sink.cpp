@@ -0,0 +1,123 @@
+#include "output_sink.h"
+
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+#include "task_io.h"
+
+using namespace std;
+
+// ============================================================================
+// SINK IMPLEMENTATIONS
+// ============================================================================
+
+ConsoleSink::ConsoleSink()
+    : out_(taskConsole()) {
+}
+
+void ConsoleSink::write(const char* data, size_t size) {
+    out_.write(data, static_cast<streamsize>(size));
+}
+
+void ConsoleSink::flush() {
+    out_.flush();
+}
+
+FileSink::FileSink(const string& filepath, bool append, bool binary)
+    : file_(filepath, (append ? ios::out | ios::app : ios::out) | (binary ? ios::binary : ios::openmode())),
+    path_(filepath),
+    append_(append),
+    binary_(binary) {
+    if (!file_.is_open()) {
+        throw runtime_error("Cannot open output file: " + filepath);
+    }
+}
+
+void FileSink::write(const char* data, size_t size) {
+    file_.write(data, static_cast<streamsize>(size));
+}
+
+void FileSink::flush() {
+    file_.flush();
+}
+
+void FileSink::beginPositional(size_t size) {
+    file_.flush();
+    rangeStart_ = static_cast<uint64_t>(file_.tellp());
+    rangeSize_ = size;
+    if (!positional_) {
+        positional_ = make_unique<PositionalFile>(path_);
+    }
+}
+
+void FileSink::writeAt(size_t offset, const char* data, size_t size) {
+    positional_->write(rangeStart_ + offset, data, size);
+}
+
+void FileSink::endPositional() {
+    file_.seekp(static_cast<streamoff>(rangeStart_ + rangeSize_));
+}
+
+void MemorySink::write(const char* data, size_t size) {
+    target_.append(data, size);
+}
+
+// ============================================================================
+// OUTPUT MODE SELECTION
+// ============================================================================
+
+namespace {
+    atomic<OutputMode> g_outputMode{ OutputMode::DUAL };
+
+    mutex g_captureMutex;
+    map<string, string> g_captures;  // std::map keeps references stable
+}
+
+void setOutputMode(OutputMode mode) {
+    g_outputMode.store(mode);
+}
+
+OutputMode getOutputMode() {
+    return g_outputMode.load();
+}
+
+string& capturedOutput(const string& filepath) {
+    lock_guard<mutex> lock(g_captureMutex);
+    return g_captures[filepath];
+}
+
+vector<unique_ptr<OutputSink>> makeSinks(const string& filepath, bool append, bool binary) {
+    vector<unique_ptr<OutputSink>> sinks;
+
+    switch (getOutputMode()) {
+    case OutputMode::DUAL:
+        sinks.push_back(make_unique<ConsoleSink>());
+        sinks.push_back(make_unique<FileSink>(filepath, append, binary));
+        break;
+    case OutputMode::CONSOLE_ONLY:
+        sinks.push_back(make_unique<ConsoleSink>());
+        break;
+    case OutputMode::FILE_ONLY:
+        sinks.push_back(make_unique<FileSink>(filepath, append, binary));
+        break;
+    case OutputMode::MAPPED_FILE:
+        sinks.push_back(make_unique<MappedFileSink>(filepath, append));
+        break;
+    case OutputMode::MEMORY_ONLY: {
+        string& target = capturedOutput(filepath);
+        if (!append) {
+            target.clear();
+        }
+        sinks.push_back(make_unique<MemorySink>(target));
+        break;
+    }
+    case OutputMode::DISCARD:
+        sinks.push_back(make_unique<NullSink>());
+        break;
+    }
+
+    return sinks;
+}
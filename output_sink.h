@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+
+/**
+ * @brief Destination for bytes produced by DualOutputWriter.
+ * Sinks are driven from the writer's flush thread only, so implementations
+ * need no locking of their own. The one exception is a positional range
+ * (see beginPositional()), filled by several threads while the ring is empty.
+ */
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+
+    /**
+     * @brief Writes a block of formatted bytes.
+     * @param data Pointer to the bytes
+     * @param size Number of bytes
+     */
+    virtual void write(const char* data, std::size_t size) = 0;
+
+    /**
+     * @brief Pushes buffered bytes to the underlying device.
+     */
+    virtual void flush() {}
+
+    /**
+     * @brief Returns true if the sink accepts writes at arbitrary offsets.
+     */
+    virtual bool positional() const {
+        return false;
+    }
+
+    /**
+     * @brief Opens a range of size bytes after everything written so far.
+     * Only called on positional sinks, with all earlier writes delivered.
+     */
+    virtual void beginPositional(std::size_t) {}
+
+    /**
+     * @brief Writes into the open range; offset is relative to its start.
+     * Safe to call from several threads for disjoint parts of the range.
+     */
+    virtual void writeAt(std::size_t, const char*, std::size_t) {}
+
+    /**
+     * @brief Closes the range; later write() calls continue after it.
+     */
+    virtual void endPositional() {}
+};
+
+/**
+ * @brief Writes to the console of the task that created it.
+ * The stream is taken from taskConsole() on construction (std::cout unless a
+ * batch job redirected it), because writes happen later on the flush thread.
+ */
+class ConsoleSink : public OutputSink {
+private:
+    std::ostream& out_;
+
+public:
+    ConsoleSink();
+
+    void write(const char* data, std::size_t size) override;
+    void flush() override;
+};
+
+/**
+ * @brief Writes to a file opened for overwrite or append.
+ */
+class FileSink : public OutputSink {
+private:
+    std::ofstream file_;
+    std::string path_;
+    bool append_;
+    bool binary_;
+    std::unique_ptr<PositionalFile> positional_;  ///< Opened on the first positional range
+    std::uint64_t rangeStart_ = 0;
+    std::size_t rangeSize_ = 0;
+
+public:
+    /**
+     * @brief Opens the output file.
+     * @param filepath Path to the output file
+     * @param append If true, appends to existing file; otherwise overwrites
+     * @param binary If true, bytes are written as is (no newline translation on Windows)
+     * @throws runtime_error if file cannot be opened
+     */
+    explicit FileSink(const std::string& filepath, bool append = false, bool binary = false);
+
+    void write(const char* data, std::size_t size) override;
+    void flush() override;
+
+    /**
+     * @brief Positional writes use pwrite; append mode stays sequential
+     * because O_APPEND ignores the offset. On Windows text files stay
+     * sequential too: the stream writes "\r\n" where pwrite would write "\n".
+     */
+    bool positional() const override {
+#ifdef _WIN32
+        return !append_ && binary_;
+#else
+        return !append_;
+#endif
+    }
+
+    void beginPositional(std::size_t size) override;
+    void writeAt(std::size_t offset, const char* data, std::size_t size) override;
+    void endPositional() override;
+};
+
+/**
+ * @brief Writes into a memory-mapped file preallocated in large extents.
+ */
+class MappedFileSink : public OutputSink {
+private:
+    MappedOutputFile file_;
+    std::size_t rangeStart_ = 0;
+
+public:
+    /**
+     * @brief Creates and maps the output file.
+     * @param filepath Path to the output file
+     * @param append If true, appends to existing file; otherwise overwrites
+     * @throws runtime_error if file cannot be created or mapped
+     */
+    explicit MappedFileSink(const std::string& filepath, bool append = false)
+        : file_(filepath, append) {}
+
+    void write(const char* data, std::size_t size) override {
+        file_.append(data, size);
+    }
+
+    bool positional() const override {
+        return true;
+    }
+
+    void beginPositional(std::size_t size) override {
+        rangeStart_ = file_.size();
+        file_.resize(rangeStart_ + size);
+    }
+
+    void writeAt(std::size_t offset, const char* data, std::size_t size) override {
+        std::memcpy(file_.at(rangeStart_ + offset), data, size);
+    }
+};
+
+/**
+ * @brief Discards everything written to it.
+ */
+class NullSink : public OutputSink {
+public:
+    void write(const char*, std::size_t) override {}
+
+    bool positional() const override {
+        return true;
+    }
+};
+
+/**
+ * @brief Appends everything written to it to a caller-owned string.
+ * The string must outlive the writer and must not be read until the writer is flushed.
+ */
+class MemorySink : public OutputSink {
+private:
+    std::string& target_;
+
+public:
+    explicit MemorySink(std::string& target) : target_(target) {}
+
+    void write(const char* data, std::size_t size) override;
+};
+
+/**
+ * @brief Selects which sinks DualOutputWriter(filepath) creates.
+ */
+enum class OutputMode {
+    DUAL,           ///< Console and file (default)
+    CONSOLE_ONLY,   ///< Console only; file is not created
+    FILE_ONLY,      ///< File only; nothing reaches the terminal
+    MAPPED_FILE,    ///< File only, written through a memory mapping (large outputs)
+    MEMORY_ONLY,    ///< Kept in memory, see capturedOutput()
+    DISCARD         ///< Discarded (null sink)
+};
+
+/**
+ * @brief Sets the process-wide output mode used by writers created afterwards.
+ * @param mode New output mode
+ */
+void setOutputMode(OutputMode mode);
+
+/**
+ * @brief Returns the current process-wide output mode.
+ */
+OutputMode getOutputMode();
+
+/**
+ * @brief Returns the in-memory contents written to a path in MEMORY_ONLY mode.
+ * @param filepath Path the writer was created with
+ * @return Reference to the captured text (empty if nothing was written)
+ */
+std::string& capturedOutput(const std::string& filepath);
+
+/**
+ * @brief Builds the sinks for a writer according to the current output mode.
+ * @param filepath Path to the output file
+ * @param append If true, appends to existing file/capture; otherwise overwrites
+ * @param binary If true, the file sink writes bytes as is (see FileSink)
+ * @return Sinks in write order
+ * @throws runtime_error if the file sink cannot be opened
+ */
+std::vector<std::unique_ptr<OutputSink>> makeSinks(const std::string& filepath, bool append = false,
+    bool binary = false);
@@ -0,0 +1,231 @@
+#include "pairwise_sum.h"
+#include "cpu_features.h"
+
+#include <algorithm>
+#include <array>
+#include <future>
+#include <vector>
+
+#if LAB_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// Every variant keeps lane k of a block in the same accumulator and adds the
+// values in the same order, so vector and scalar block sums are identical.
+
+namespace {
+    using BlockKernel = double (*)(const double*, size_t);
+
+    // Blocks summed by one pool task (about 256 KiB of values)
+    constexpr size_t BLOCKS_PER_TASK = 16;
+
+    /**
+     * @brief Adds the values after the last full group of SUM_LANES to their
+     * lanes, then folds the lanes as a balanced tree (lane k + lane k + half).
+     */
+    double finishBlock(const double* values, size_t full, size_t count, double* lanes) {
+        for (size_t k = full; k < count; ++k) {
+            lanes[k % SUM_LANES] += values[k];
+        }
+        for (size_t half = SUM_LANES / 2; half > 0; half /= 2) {
+            for (size_t k = 0; k < half; ++k) {
+                lanes[k] += lanes[k + half];
+            }
+        }
+        return lanes[0];
+    }
+
+    double blockScalar(const double* values, size_t count) {
+        double lanes[SUM_LANES] = {};
+        const size_t full = count - count % SUM_LANES;
+        for (size_t i = 0; i < full; i += SUM_LANES) {
+            for (size_t k = 0; k < SUM_LANES; ++k) {
+                lanes[k] += values[i + k];
+            }
+        }
+        return finishBlock(values, full, count, lanes);
+    }
+
+#if LAB_X86
+    // Several registers per block so independent add chains hide the add latency
+
+    double blockSse2(const double* values, size_t count) {
+        __m128d r0 = _mm_setzero_pd(), r1 = _mm_setzero_pd(), r2 = _mm_setzero_pd(), r3 = _mm_setzero_pd();
+        __m128d r4 = _mm_setzero_pd(), r5 = _mm_setzero_pd(), r6 = _mm_setzero_pd(), r7 = _mm_setzero_pd();
+        const size_t full = count - count % SUM_LANES;
+        for (size_t i = 0; i < full; i += SUM_LANES) {
+            r0 = _mm_add_pd(r0, _mm_loadu_pd(values + i));
+            r1 = _mm_add_pd(r1, _mm_loadu_pd(values + i + 2));
+            r2 = _mm_add_pd(r2, _mm_loadu_pd(values + i + 4));
+            r3 = _mm_add_pd(r3, _mm_loadu_pd(values + i + 6));
+            r4 = _mm_add_pd(r4, _mm_loadu_pd(values + i + 8));
+            r5 = _mm_add_pd(r5, _mm_loadu_pd(values + i + 10));
+            r6 = _mm_add_pd(r6, _mm_loadu_pd(values + i + 12));
+            r7 = _mm_add_pd(r7, _mm_loadu_pd(values + i + 14));
+        }
+
+        double lanes[SUM_LANES];
+        _mm_storeu_pd(lanes, r0);
+        _mm_storeu_pd(lanes + 2, r1);
+        _mm_storeu_pd(lanes + 4, r2);
+        _mm_storeu_pd(lanes + 6, r3);
+        _mm_storeu_pd(lanes + 8, r4);
+        _mm_storeu_pd(lanes + 10, r5);
+        _mm_storeu_pd(lanes + 12, r6);
+        _mm_storeu_pd(lanes + 14, r7);
+        return finishBlock(values, full, count, lanes);
+    }
+
+    LAB_TARGET("avx2")
+    double blockAvx2(const double* values, size_t count) {
+        __m256d r0 = _mm256_setzero_pd(), r1 = _mm256_setzero_pd();
+        __m256d r2 = _mm256_setzero_pd(), r3 = _mm256_setzero_pd();
+        const size_t full = count - count % SUM_LANES;
+        for (size_t i = 0; i < full; i += SUM_LANES) {
+            r0 = _mm256_add_pd(r0, _mm256_loadu_pd(values + i));
+            r1 = _mm256_add_pd(r1, _mm256_loadu_pd(values + i + 4));
+            r2 = _mm256_add_pd(r2, _mm256_loadu_pd(values + i + 8));
+            r3 = _mm256_add_pd(r3, _mm256_loadu_pd(values + i + 12));
+        }
+
+        double lanes[SUM_LANES];
+        _mm256_storeu_pd(lanes, r0);
+        _mm256_storeu_pd(lanes + 4, r1);
+        _mm256_storeu_pd(lanes + 8, r2);
+        _mm256_storeu_pd(lanes + 12, r3);
+        return finishBlock(values, full, count, lanes);
+    }
+
+    LAB_TARGET("avx512f")
+    double blockAvx512(const double* values, size_t count) {
+        __m512d low = _mm512_setzero_pd();
+        __m512d high = _mm512_setzero_pd();
+        const size_t full = count - count % SUM_LANES;
+        for (size_t i = 0; i < full; i += SUM_LANES) {
+            low = _mm512_add_pd(low, _mm512_loadu_pd(values + i));
+            high = _mm512_add_pd(high, _mm512_loadu_pd(values + i + 8));
+        }
+
+        double lanes[SUM_LANES];
+        _mm512_storeu_pd(lanes, low);
+        _mm512_storeu_pd(lanes + 8, high);
+        return finishBlock(values, full, count, lanes);
+    }
+#endif
+
+    BlockKernel blockKernel() {
+#if LAB_X86
+        switch (simdLevel()) {
+        case SimdLevel::AVX512:
+            return blockAvx512;
+        case SimdLevel::AVX2:
+            return blockAvx2;
+        case SimdLevel::SSE2:
+            return blockSse2;
+        default:
+            break;
+        }
+#endif
+        return blockScalar;
+    }
+
+    size_t blockCount(size_t count) {
+        return (count + SUM_BLOCK - 1) / SUM_BLOCK;
+    }
+
+    /**
+     * @brief Adds precomputed block sums as a balanced tree (left half + right half).
+     */
+    double combinePairwise(const double* sums, size_t count) {
+        if (count == 0) {
+            return 0.0;
+        }
+        if (count == 1) {
+            return sums[0];
+        }
+        const size_t half = count / 2;
+        return combinePairwise(sums, half) + combinePairwise(sums + half, count - half);
+    }
+
+    /**
+     * @brief Same tree as combinePairwise(), computing the block sums at the leaves.
+     */
+    double sumBlocks(BlockKernel kernel, const double* values, size_t count, size_t firstBlock, size_t blocks) {
+        if (blocks == 1) {
+            const size_t start = firstBlock * SUM_BLOCK;
+            return kernel(values + start, min(SUM_BLOCK, count - start));
+        }
+        const size_t half = blocks / 2;
+        return sumBlocks(kernel, values, count, firstBlock, half)
+            + sumBlocks(kernel, values, count, firstBlock + half, blocks - half);
+    }
+
+    /**
+     * @brief Runs blockSum(block) for every block on the pool and combines the results.
+     * A single task's worth of blocks runs on the calling thread.
+     */
+    template<typename BlockSum>
+    double sumBlocksParallel(ThreadPool& pool, size_t blocks, const BlockSum& blockSum) {
+        vector<double> sums(blocks);
+        auto sumRange = [&](size_t first) {
+            const size_t last = min(blocks, first + BLOCKS_PER_TASK);
+            for (size_t block = first; block < last; ++block) {
+                sums[block] = blockSum(block);
+            }
+        };
+
+        if (blocks <= BLOCKS_PER_TASK) {
+            sumRange(0);
+        }
+        else {
+            vector<future<void>> pending;
+            pending.reserve((blocks + BLOCKS_PER_TASK - 1) / BLOCKS_PER_TASK);
+            for (size_t first = 0; first < blocks; first += BLOCKS_PER_TASK) {
+                pending.push_back(pool.submit([&sumRange, first]() { sumRange(first); }));
+            }
+            ThreadPool::waitAll(pending);
+        }
+        return combinePairwise(sums.data(), sums.size());
+    }
+}
+
+double pairwiseSum(const double* values, size_t count) {
+    if (count == 0) {
+        return 0.0;
+    }
+    return sumBlocks(blockKernel(), values, count, 0, blockCount(count));
+}
+
+double pairwiseSum(ThreadPool& pool, const double* values, size_t count) {
+    const BlockKernel kernel = blockKernel();
+    return sumBlocksParallel(pool, blockCount(count), [&](size_t block) {
+        const size_t start = block * SUM_BLOCK;
+        return kernel(values + start, min(SUM_BLOCK, count - start));
+    });
+}
+
+double pairwiseSum(ThreadPool& pool, long long count, const SumBlockFill& fill) {
+    if (count <= 0) {
+        return 0.0;
+    }
+
+    const BlockKernel kernel = blockKernel();
+    const size_t total = static_cast<size_t>(count);
+    return sumBlocksParallel(pool, blockCount(total), [&](size_t block) {
+        array<double, SUM_BLOCK> values;
+        const size_t start = block * SUM_BLOCK;
+        const size_t size = min(SUM_BLOCK, total - start);
+        fill(static_cast<long long>(start), size, values.data());
+        return kernel(values.data(), size);
+    });
+}
+
+long long wrappingSum(const long long* values, size_t count) {
+    unsigned long long sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += static_cast<unsigned long long>(values[i]);
+    }
+    return static_cast<long long>(sum);
+}
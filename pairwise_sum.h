@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include "thread_pool.h"
+
+// Values summed per block; block sums are then combined pairwise
+constexpr std::size_t SUM_BLOCK = 2048;
+
+// Interleaved accumulators per block (lane k takes values k, k + 16, ...).
+// The SIMD kernels in pairwise_sum.cpp hold exactly this many lanes.
+constexpr std::size_t SUM_LANES = 16;
+
+/**
+ * @brief Sums values in an order fixed by the data alone.
+ * Each block of SUM_BLOCK values is accumulated in SUM_LANES interleaved
+ * lanes, the lanes are added as a balanced tree, and the block sums are
+ * combined pairwise. Every SIMD level (and the scalar code) follows exactly
+ * this order, so the result is bit-identical on every machine. The error
+ * grows with SUM_BLOCK / SUM_LANES + log2(count / SUM_BLOCK) instead of count.
+ * @param values Values to sum
+ * @param count Number of values
+ * @return Sum, 0.0 for count == 0
+ */
+double pairwiseSum(const double* values, std::size_t count);
+
+/**
+ * @brief Same result as pairwiseSum(values, count), with the blocks spread over the pool.
+ * The result does not depend on the number of workers.
+ * @param pool Pool to run on
+ */
+double pairwiseSum(ThreadPool& pool, const double* values, std::size_t count);
+
+/**
+ * @brief Fills out with values first .. first + count - 1 of a generated sequence (0-based).
+ */
+using SumBlockFill = std::function<void(long long first, std::size_t count, double* out)>;
+
+/**
+ * @brief Sums count generated values without storing them all.
+ * Each block is generated by fill into a worker-local buffer and summed in
+ * place; the result equals pairwiseSum() over the materialized values.
+ * @param pool Pool to run on
+ * @param count Number of values
+ * @param fill Generator, called from several threads at once
+ */
+double pairwiseSum(ThreadPool& pool, long long count, const SumBlockFill& fill);
+
+/**
+ * @brief Integer sum in a plain loop; integer addition is exact, so the order
+ * does not matter and no pairwise scheme is needed.
+ * Wraps around on overflow like unsigned arithmetic instead of being undefined.
+ */
+long long wrappingSum(const long long* values, std::size_t count);
@@ -0,0 +1,38 @@
+#include "sequence_generator.h"
+#include "sequence_stats.h"
+
+using namespace std;
+
+Generator<double> arithmeticSequence(double a0, double d, long long first) {
+    for (long long i = first; ; ++i) {
+        co_yield sequenceTerm(a0, d, i);
+    }
+}
+
+Generator<double> takeWhileSumBelow(Generator<double> terms, double limit) {
+    double sum = 0.0;
+    for (double term : terms) {
+        sum += term;
+        if (sum >= limit) {
+            co_return;
+        }
+        co_yield term;
+    }
+}
+
+double sumTerms(Generator<double> terms) {
+    double sum = 0.0;
+    for (double term : terms) {
+        sum += term;
+    }
+    return sum;
+}
+
+long long writeTerms(Generator<double> terms, DualOutputWriter& output) {
+    long long count = 0;
+    for (double term : terms) {
+        output << generalField(term) << " ";
+        ++count;
+    }
+    return count;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "dual_output_writer.h"
+#include "generator.h"
+
+/**
+ * @brief Endless arithmetic sequence a0, a0 + d, ... starting at 1-based index first.
+ * Terms are the same doubles as sequenceTerm(), computed one at a time on demand.
+ */
+Generator<double> arithmeticSequence(double a0, double d, long long first = 1);
+
+/**
+ * @brief Yields terms while their running sum stays below limit.
+ * Stops on the first term that would reach the limit without pulling another.
+ */
+Generator<double> takeWhileSumBelow(Generator<double> terms, double limit);
+
+/**
+ * @brief Running sum of all terms (consumes the generator).
+ */
+double sumTerms(Generator<double> terms);
+
+/**
+ * @brief Writes every term as generalField(term) followed by a space.
+ * @return Number of terms written
+ */
+long long writeTerms(Generator<double> terms, DualOutputWriter& output);
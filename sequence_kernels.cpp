@@ -0,0 +1,199 @@
+#include "sequence_kernels.h"
+#include "cpu_features.h"
+
+#if LAB_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// Indices stay below 2^53, so converting them to double is exact in every variant.
+// No variant may fuse the multiply and add (FMA rounds once and would change the terms).
+// GCC contracts a * b + c into FMA by default in C++, intrinsics included, as soon as a
+// function targets an ISA with FMA (AVX2, AVX-512), so contraction is off for this file.
+// Each compiler has its own switch: the GCC pragma is ignored by Clang and MSVC.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract(off)
+#endif
+
+namespace {
+    void fillScalar(double a0, double d, long long first, size_t count, double* out) {
+        for (size_t k = 0; k < count; ++k) {
+            out[k] = a0 + static_cast<double>(first - 1 + static_cast<long long>(k)) * d;
+        }
+    }
+
+    /**
+     * @brief One row of sequenceStatsBatch(): empty rows become a0 = d = 0, n = 1
+     * (sum 0, average 0), so the arithmetic is the same for every row.
+     */
+    void statsScalar(const double* a0, const double* d, const double* n, size_t rows,
+        double* sum, double* average) {
+        for (size_t i = 0; i < rows; ++i) {
+            const bool empty = !(n[i] > 0.0);
+            const double first = empty ? 0.0 : a0[i];
+            const double step = empty ? 0.0 : d[i];
+            const double count = empty ? 1.0 : n[i];
+            const double total = count * (first + (first + (count - 1.0) * step)) * 0.5;
+            sum[i] = total;
+            average[i] = total / count;
+        }
+    }
+
+#if LAB_X86
+    void fillSse2(double a0, double d, long long first, size_t count, double* out) {
+        const __m128d base = _mm_set1_pd(a0);
+        const __m128d step = _mm_set1_pd(d);
+        const __m128d stride = _mm_set1_pd(2.0);
+        __m128d index = _mm_set_pd(static_cast<double>(first), static_cast<double>(first - 1));
+
+        size_t k = 0;
+        for (; k + 2 <= count; k += 2) {
+            _mm_storeu_pd(out + k, _mm_add_pd(base, _mm_mul_pd(index, step)));
+            index = _mm_add_pd(index, stride);
+        }
+        fillScalar(a0, d, first + static_cast<long long>(k), count - k, out + k);
+    }
+
+    void statsSse2(const double* a0, const double* d, const double* n, size_t rows,
+        double* sum, double* average) {
+        const __m128d zero = _mm_setzero_pd();
+        const __m128d one = _mm_set1_pd(1.0);
+        const __m128d half = _mm_set1_pd(0.5);
+
+        size_t i = 0;
+        for (; i + 2 <= rows; i += 2) {
+            const __m128d count = _mm_loadu_pd(n + i);
+            const __m128d valid = _mm_cmpgt_pd(count, zero);
+            const __m128d first = _mm_and_pd(valid, _mm_loadu_pd(a0 + i));
+            const __m128d step = _mm_and_pd(valid, _mm_loadu_pd(d + i));
+            const __m128d terms = _mm_or_pd(_mm_and_pd(valid, count), _mm_andnot_pd(valid, one));
+            const __m128d last = _mm_add_pd(first, _mm_mul_pd(_mm_sub_pd(terms, one), step));
+            const __m128d total = _mm_mul_pd(_mm_mul_pd(terms, _mm_add_pd(first, last)), half);
+            _mm_storeu_pd(sum + i, total);
+            _mm_storeu_pd(average + i, _mm_div_pd(total, terms));
+        }
+        statsScalar(a0 + i, d + i, n + i, rows - i, sum + i, average + i);
+    }
+
+    LAB_TARGET("avx2")
+    void fillAvx2(double a0, double d, long long first, size_t count, double* out) {
+        const __m256d base = _mm256_set1_pd(a0);
+        const __m256d step = _mm256_set1_pd(d);
+        const __m256d stride = _mm256_set1_pd(4.0);
+        const double i0 = static_cast<double>(first - 1);
+        __m256d index = _mm256_set_pd(i0 + 3.0, i0 + 2.0, i0 + 1.0, i0);
+
+        size_t k = 0;
+        for (; k + 4 <= count; k += 4) {
+            _mm256_storeu_pd(out + k, _mm256_add_pd(base, _mm256_mul_pd(index, step)));
+            index = _mm256_add_pd(index, stride);
+        }
+        fillScalar(a0, d, first + static_cast<long long>(k), count - k, out + k);
+    }
+
+    LAB_TARGET("avx2")
+    void statsAvx2(const double* a0, const double* d, const double* n, size_t rows,
+        double* sum, double* average) {
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d one = _mm256_set1_pd(1.0);
+        const __m256d half = _mm256_set1_pd(0.5);
+
+        size_t i = 0;
+        for (; i + 4 <= rows; i += 4) {
+            const __m256d count = _mm256_loadu_pd(n + i);
+            const __m256d valid = _mm256_cmp_pd(count, zero, _CMP_GT_OQ);
+            const __m256d first = _mm256_and_pd(valid, _mm256_loadu_pd(a0 + i));
+            const __m256d step = _mm256_and_pd(valid, _mm256_loadu_pd(d + i));
+            const __m256d terms = _mm256_blendv_pd(one, count, valid);
+            const __m256d last = _mm256_add_pd(first, _mm256_mul_pd(_mm256_sub_pd(terms, one), step));
+            const __m256d total = _mm256_mul_pd(_mm256_mul_pd(terms, _mm256_add_pd(first, last)), half);
+            _mm256_storeu_pd(sum + i, total);
+            _mm256_storeu_pd(average + i, _mm256_div_pd(total, terms));
+        }
+        statsScalar(a0 + i, d + i, n + i, rows - i, sum + i, average + i);
+    }
+
+    LAB_TARGET("avx512f")
+    void fillAvx512(double a0, double d, long long first, size_t count, double* out) {
+        const __m512d base = _mm512_set1_pd(a0);
+        const __m512d step = _mm512_set1_pd(d);
+        const __m512d stride = _mm512_set1_pd(8.0);
+        const double i0 = static_cast<double>(first - 1);
+        __m512d index = _mm512_set_pd(i0 + 7.0, i0 + 6.0, i0 + 5.0, i0 + 4.0,
+            i0 + 3.0, i0 + 2.0, i0 + 1.0, i0);
+
+        size_t k = 0;
+        for (; k + 8 <= count; k += 8) {
+            _mm512_storeu_pd(out + k, _mm512_add_pd(base, _mm512_mul_pd(index, step)));
+            index = _mm512_add_pd(index, stride);
+        }
+        fillScalar(a0, d, first + static_cast<long long>(k), count - k, out + k);
+    }
+
+    LAB_TARGET("avx512f")
+    void statsAvx512(const double* a0, const double* d, const double* n, size_t rows,
+        double* sum, double* average) {
+        const __m512d zero = _mm512_setzero_pd();
+        const __m512d one = _mm512_set1_pd(1.0);
+        const __m512d half = _mm512_set1_pd(0.5);
+
+        size_t i = 0;
+        for (; i + 8 <= rows; i += 8) {
+            const __m512d count = _mm512_loadu_pd(n + i);
+            const __mmask8 valid = _mm512_cmp_pd_mask(count, zero, _CMP_GT_OQ);
+            const __m512d first = _mm512_maskz_loadu_pd(valid, a0 + i);
+            const __m512d step = _mm512_maskz_loadu_pd(valid, d + i);
+            const __m512d terms = _mm512_mask_blend_pd(valid, one, count);
+            const __m512d last = _mm512_add_pd(first, _mm512_mul_pd(_mm512_sub_pd(terms, one), step));
+            const __m512d total = _mm512_mul_pd(_mm512_mul_pd(terms, _mm512_add_pd(first, last)), half);
+            _mm512_storeu_pd(sum + i, total);
+            _mm512_storeu_pd(average + i, _mm512_div_pd(total, terms));
+        }
+        statsScalar(a0 + i, d + i, n + i, rows - i, sum + i, average + i);
+    }
+#endif
+}
+
+void fillSequenceTerms(double a0, double d, long long first, size_t count, double* out) {
+#if LAB_X86
+    switch (simdLevel()) {
+    case SimdLevel::AVX512:
+        fillAvx512(a0, d, first, count, out);
+        return;
+    case SimdLevel::AVX2:
+        fillAvx2(a0, d, first, count, out);
+        return;
+    case SimdLevel::SSE2:
+        fillSse2(a0, d, first, count, out);
+        return;
+    default:
+        break;
+    }
+#endif
+    fillScalar(a0, d, first, count, out);
+}
+
+void sequenceStatsBatch(const double* a0, const double* d, const double* n, size_t rows,
+    double* sum, double* average) {
+#if LAB_X86
+    switch (simdLevel()) {
+    case SimdLevel::AVX512:
+        statsAvx512(a0, d, n, rows, sum, average);
+        return;
+    case SimdLevel::AVX2:
+        statsAvx2(a0, d, n, rows, sum, average);
+        return;
+    case SimdLevel::SSE2:
+        statsSse2(a0, d, n, rows, sum, average);
+        return;
+    default:
+        break;
+    }
+#endif
+    statsScalar(a0, d, n, rows, sum, average);
+}
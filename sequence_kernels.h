@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Fills out with terms first .. first + count - 1 of the sequence a0, a0 + d, ...
+ * Dispatches on simdLevel() to AVX-512, AVX2, SSE2 or scalar code. Every
+ * variant computes a0 + (i - 1) * d with a separate multiply and add, so all
+ * of them produce exactly the same doubles as sequenceTerm().
+ * @param a0 Initial term
+ * @param d Common difference
+ * @param first 1-based index of the first term to generate
+ * @param count Number of terms
+ * @param out Destination, at least count doubles
+ */
+void fillSequenceTerms(double a0, double d, long long first, std::size_t count, double* out);
+
+/**
+ * @brief sequenceStats() of many sequences at once, over column arrays.
+ * Dispatches like fillSequenceTerms(); every variant uses the operations of
+ * sequenceStats() (empty rows are masked to 0), so each row's sum and average
+ * equal sequenceStats(a0[i], d[i], n[i]) bit for bit.
+ * @param a0 Initial terms
+ * @param d Common differences
+ * @param n Numbers of terms as doubles (exact below 2^53; <= 0 means empty)
+ * @param rows Number of sequences
+ * @param sum Sums (output)
+ * @param average Averages (output, 0 for empty rows)
+ */
+void sequenceStatsBatch(const double* a0, const double* d, const double* n, std::size_t rows,
+    double* sum, double* average);
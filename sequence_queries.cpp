@@ -0,0 +1,211 @@
+#include "sequence_queries.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "dual_output_writer.h"
+#include "fast_format.h"
+#include "instrumentation.h"
+#include "mapped_file.h"
+#include "sequence_kernels.h"
+#include "sequence_stats.h"
+#include "text_scanner.h"
+
+using namespace std;
+
+namespace {
+    // Input bytes per range handed to one pool task
+    constexpr size_t RANGE_BYTES = 1 << 20;
+
+    /**
+     * @brief Queries of one range in column layout, with their results.
+     */
+    struct QueryBatch {
+        vector<double> a0, d, n, limit;
+        vector<double> sum, average;
+        vector<double> limitedCount, limitedSum, limitedAverage;
+        size_t skipped = 0;
+        string firstInvalidRow;
+
+        size_t size() const {
+            return a0.size();
+        }
+
+        void clear() {
+            a0.clear();
+            d.clear();
+            n.clear();
+            limit.clear();
+            skipped = 0;
+            firstInvalidRow.clear();
+        }
+    };
+
+    /**
+     * @brief Cuts the text into ranges of about RANGE_BYTES that end after a newline.
+     */
+    vector<string_view> splitLines(string_view text) {
+        vector<string_view> ranges;
+        size_t begin = 0;
+        while (begin < text.size()) {
+            size_t end = min(text.size(), begin + RANGE_BYTES);
+            if (end < text.size()) {
+                size_t newline = text.find('\n', end);
+                end = (newline == string_view::npos) ? text.size() : newline + 1;
+            }
+            ranges.push_back(text.substr(begin, end - begin));
+            begin = end;
+        }
+        return ranges;
+    }
+
+    /**
+     * @brief Parses the rows of a range into the batch columns.
+     * Invalid rows are counted in batch.skipped, the first one kept as text.
+     */
+    void parseQueries(string_view range, QueryBatch& batch) {
+        LAB_PHASE(Phase::PARSE);
+        batch.clear();
+
+        while (!range.empty()) {
+            size_t newline = range.find('\n');
+            string_view line = range.substr(0, newline);
+            range.remove_prefix(newline == string_view::npos ? range.size() : newline + 1);
+
+            size_t first = line.find_first_not_of(" \t\r");
+            if (first == string_view::npos || line[first] == '#') {
+                continue;
+            }
+
+            TextScanner scanner(line);
+            double a0, d, limit = 0.0;
+            long long n;
+            string_view rest;
+            bool valid = scanner.next(a0) && scanner.next(d) && scanner.next(n) && n >= 0;
+            if (valid && !scanner.next(limit)) {
+                limit = 0.0;
+            }
+            if (!valid || scanner.next(rest)) {
+                if (batch.skipped++ == 0) {
+                    batch.firstInvalidRow = string(line);
+                }
+                continue;
+            }
+
+            batch.a0.push_back(a0);
+            batch.d.push_back(d);
+            batch.n.push_back(static_cast<double>(n));
+            batch.limit.push_back(limit);
+        }
+    }
+
+    /**
+     * @brief Computes full and limited statistics of every query in the batch.
+     * The statistics run column-wise; only the limit cutoff is solved per row.
+     */
+    void evaluateQueries(QueryBatch& batch) {
+        LAB_PHASE(Phase::COMPUTE);
+        const size_t rows = batch.size();
+        batch.sum.resize(rows);
+        batch.average.resize(rows);
+        batch.limitedCount.resize(rows);
+        batch.limitedSum.resize(rows);
+        batch.limitedAverage.resize(rows);
+
+        sequenceStatsBatch(batch.a0.data(), batch.d.data(), batch.n.data(), rows,
+            batch.sum.data(), batch.average.data());
+
+        for (size_t i = 0; i < rows; ++i) {
+            const long long n = static_cast<long long>(batch.n[i]);
+            batch.limitedCount[i] = (batch.limit[i] > 0.0)
+                ? static_cast<double>(termsBelowLimit(batch.a0[i], batch.d[i], n, batch.limit[i]))
+                : batch.n[i];
+        }
+
+        sequenceStatsBatch(batch.a0.data(), batch.d.data(), batch.limitedCount.data(), rows,
+            batch.limitedSum.data(), batch.limitedAverage.data());
+        LAB_COUNT(Counter::RECORDS, rows);
+    }
+
+    void formatText(const QueryBatch& batch, string& out) {
+        LAB_PHASE(Phase::FORMAT);
+        const size_t rows = batch.size();
+        // Slack for the widest field that formatField() may need near the end
+        out.resize(rows * QUERY_TEXT_RECORD_SIZE + fast_format::MAX_GENERAL_CHARS + QUERY_VALUE_PRECISION);
+
+        char* pos = out.data();
+        for (size_t i = 0; i < rows; ++i) {
+            pos = fast_format::formatField(pos, intField(static_cast<long long>(batch.n[i]), QUERY_COUNT_WIDTH));
+            pos = fast_format::formatField(pos, generalField(batch.sum[i], QUERY_VALUE_WIDTH, QUERY_VALUE_PRECISION));
+            pos = fast_format::formatField(pos, generalField(batch.average[i], QUERY_VALUE_WIDTH, QUERY_VALUE_PRECISION));
+            pos = fast_format::formatField(pos, intField(static_cast<long long>(batch.limitedCount[i]), QUERY_COUNT_WIDTH));
+            pos = fast_format::formatField(pos, generalField(batch.limitedSum[i], QUERY_VALUE_WIDTH, QUERY_VALUE_PRECISION));
+            pos = fast_format::formatField(pos, generalField(batch.limitedAverage[i], QUERY_VALUE_WIDTH, QUERY_VALUE_PRECISION));
+            *pos++ = '\n';
+        }
+        out.resize(static_cast<size_t>(pos - out.data()));
+    }
+
+    void formatBinary(const QueryBatch& batch, string& out) {
+        LAB_PHASE(Phase::FORMAT);
+        const size_t rows = batch.size();
+        out.resize(rows * sizeof(QueryRecord));
+
+        for (size_t i = 0; i < rows; ++i) {
+            QueryRecord record;
+            record.count = static_cast<int64_t>(batch.n[i]);
+            record.sum = batch.sum[i];
+            record.average = batch.average[i];
+            record.limitedCount = static_cast<int64_t>(batch.limitedCount[i]);
+            record.limitedSum = batch.limitedSum[i];
+            record.limitedAverage = batch.limitedAverage[i];
+            memcpy(out.data() + i * sizeof(QueryRecord), &record, sizeof(QueryRecord));
+        }
+    }
+}
+
+QueryRunSummary runSequenceQueries(const string& inputPath, const string& outputPath,
+    QueryFormat format, ThreadPool& pool) {
+    MappedInputFile inputFile(inputPath);
+    if (!inputFile.is_open()) {
+        throw runtime_error("Input file '" + inputPath + "' not found");
+    }
+
+    const vector<string_view> ranges = splitLines(inputFile.view());
+    atomic<size_t> queries{ 0 };
+    vector<size_t> skipped(ranges.size(), 0);
+    vector<string> firstInvalidRows(ranges.size());
+
+    DualOutputWriter output(makeSinks(outputPath, false, format == QueryFormat::BINARY));
+    output.writeChunks(pool, static_cast<long long>(ranges.size()), 1,
+        [&](long long first, long long, string& out) {
+            QueryBatch batch;
+            parseQueries(ranges[static_cast<size_t>(first)], batch);
+            evaluateQueries(batch);
+            if (format == QueryFormat::BINARY) {
+                formatBinary(batch, out);
+            }
+            else {
+                formatText(batch, out);
+            }
+            queries.fetch_add(batch.size(), memory_order_relaxed);
+            skipped[static_cast<size_t>(first)] = batch.skipped;
+            firstInvalidRows[static_cast<size_t>(first)] = move(batch.firstInvalidRow);
+        });
+    output.flush();
+
+    // Each range filled its own slots; the earliest range has the first invalid row
+    QueryRunSummary summary;
+    summary.queries = queries.load();
+    for (size_t range = 0; range < ranges.size(); ++range) {
+        if (skipped[range] > 0 && summary.skipped == 0) {
+            summary.firstInvalidRow = move(firstInvalidRows[range]);
+        }
+        summary.skipped += skipped[range];
+    }
+    return summary;
+}
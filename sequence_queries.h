@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "thread_pool.h"
+
+/**
+ * @brief Layout of the results written by runSequenceQueries().
+ */
+enum class QueryFormat {
+    TEXT,       ///< One fixed-width line per query (QUERY_TEXT_RECORD_SIZE bytes)
+    BINARY      ///< One QueryRecord per query, native byte order
+};
+
+/**
+ * @brief Result of one (a0, d, n, limit) query in the binary format.
+ * The limited fields describe the leading terms whose running sum stays
+ * below the limit; without a limit they repeat the full statistics.
+ */
+struct QueryRecord {
+    std::int64_t count;
+    double sum;
+    double average;
+    std::int64_t limitedCount;
+    double limitedSum;
+    double limitedAverage;
+};
+
+static_assert(sizeof(QueryRecord) == 48, "QueryRecord must have no padding");
+
+// Text record: count, sum, average, limited count, limited sum, limited average and '\n'.
+// Sums and averages use 17 significant digits, so they read back exactly.
+constexpr int QUERY_COUNT_WIDTH = 20;
+constexpr int QUERY_VALUE_WIDTH = 25;
+constexpr int QUERY_VALUE_PRECISION = 17;
+constexpr std::size_t QUERY_TEXT_RECORD_SIZE = 2 * QUERY_COUNT_WIDTH + 4 * QUERY_VALUE_WIDTH + 1;
+
+/**
+ * @brief Outcome of runSequenceQueries().
+ */
+struct QueryRunSummary {
+    std::size_t queries = 0;        ///< Rows evaluated and written
+    std::size_t skipped = 0;        ///< Invalid rows left out of the results
+    std::string firstInvalidRow;    ///< First invalid row in file order, empty if none
+};
+
+/**
+ * @brief Evaluates a file of arithmetic progression queries with the closed-form statistics.
+ * Each non-empty line holds "a0 d n [limit]"; '#' starts a comment line and a
+ * missing or non-positive limit means no limit. The file is mapped and cut
+ * into line-aligned ranges. Each range is parsed, evaluated in column
+ * batches (sequenceStatsBatch) and formatted on the pool, and the ranges are
+ * written in input order through DualOutputWriter::writeChunks().
+ * Invalid rows are skipped like comments and counted, so one bad row does
+ * not cost the results of the others.
+ * @param inputPath Query file
+ * @param outputPath Result file (sinks follow the current OutputMode)
+ * @param format Text or binary records
+ * @param pool Pool to run on
+ * @return Rows evaluated and rows skipped
+ * @throws runtime_error if a file cannot be opened
+ */
+QueryRunSummary runSequenceQueries(const std::string& inputPath, const std::string& outputPath,
+    QueryFormat format, ThreadPool& pool);
@@ -0,0 +1,201 @@
+#include "sequence_stats.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace std;
+
+SequenceStats sequenceStats(double a0, double d, long long n) {
+    SequenceStats stats;
+    if (n <= 0) {
+        return stats;
+    }
+
+    stats.count = n;
+    stats.sum = static_cast<double>(n) * (a0 + sequenceTerm(a0, d, n)) / 2.0;
+    stats.average = stats.sum / static_cast<double>(n);
+    return stats;
+}
+
+namespace {
+    /// Terms replayed before the cutoff; shorter cutoffs are replayed from the first term
+    constexpr long long RUNNING_SUM_WINDOW = 64;
+
+    /**
+     * @brief Unevaluated sum hi + lo of two doubles.
+     */
+    struct DoubleDouble {
+        double hi = 0.0;
+        double lo = 0.0;
+    };
+
+    DoubleDouble twoSum(double a, double b) {
+        const double s = a + b;
+        const double bb = s - a;
+        return { s, (a - (s - bb)) + (b - bb) };
+    }
+
+    DoubleDouble twoProduct(double a, double b) {
+        const double p = a * b;
+        return { p, fma(a, b, -p) };
+    }
+
+    /**
+     * @brief S(k) = k * a0 + d * k * (k - 1) / 2 in double-double, good to about 1e-30 relative.
+     */
+    DoubleDouble exactSum(double a0, double d, long long k) {
+        const double terms = static_cast<double>(k);
+        const DoubleDouble first = twoProduct(terms, a0);
+        const DoubleDouble step = twoProduct(terms, d);
+        const DoubleDouble growth = twoProduct(step.hi, terms - 1.0);
+        const double growthLo = growth.lo + step.lo * (terms - 1.0);
+        const DoubleDouble sum = twoSum(first.hi, growth.hi / 2.0);
+        return { sum.hi, sum.lo + first.lo + growthLo / 2.0 };
+    }
+
+    /**
+     * @brief Smallest k in [1, top] whose exact partial sum reaches the limit, or top + 1.
+     * The partial sums must only rise on [1, top].
+     */
+    long long firstReaching(double a0, double d, long long top, double limit) {
+        long long lo = 1;
+        long long hi = top + 1;
+        while (lo < hi) {
+            const long long mid = lo + (hi - lo) / 2;
+            const DoubleDouble sum = exactSum(a0, d, mid);
+            if ((sum.hi - limit) + sum.lo >= 0.0) {
+                hi = mid;
+            }
+            else {
+                lo = mid + 1;
+            }
+        }
+        return lo;
+    }
+
+    /**
+     * @brief The loop termsBelowLimit() must agree with: terms are added one by
+     * one and the first term that brings the running sum to the limit is not taken.
+     * Only the last RUNNING_SUM_WINDOW terms before the cutoff are added; the
+     * running sum starts from the correctly rounded sum of the terms before them.
+     */
+    long long runningSumCutoff(double a0, double d, long long n, double limit) {
+        if (isnan(a0) || isnan(d) || isnan(limit)) {
+            return n;  // No comparison with NaN holds, so the loop takes every term
+        }
+
+        // When d < 0 the exact partial sums rise up to the vertex and only fall
+        // after it; when d >= 0 they stay at or above the limit once they reach it
+        long long top = n;
+        if (d < 0.0) {
+            const double vertex = 0.5 - a0 / d;
+            top = (vertex >= 1.0) ? (vertex < static_cast<double>(n) ? static_cast<long long>(vertex) : n) : 1;
+        }
+        const long long cutoff = min(firstReaching(a0, d, top, limit), top);
+        const long long first = max(0LL, cutoff - RUNNING_SUM_WINDOW);
+        const DoubleDouble start = exactSum(a0, d, first);
+
+        double sum = start.hi + start.lo;
+        for (long long i = first + 1; i <= n; ++i) {
+            const double term = sequenceTerm(a0, d, i);
+            if (sum + term >= limit) {
+                return i - 1;
+            }
+            if (term <= 0.0 && d <= 0.0) {
+                return n;  // No later term is positive, so the sum can only fall
+            }
+            sum += term;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Bound on how far the running sum of the first k terms, as
+     * runningSumCutoff() adds it, and the closed form may be from the exact sum:
+     * a few roundings of partial sums no larger than k * (|a0| + k * |d|) and of
+     * the window's terms.
+     */
+    double roundingBound(double a0, double d, long long k) {
+        const double terms = static_cast<double>(k);
+        const double largestSum = terms * (fabs(a0) + terms * fabs(d));
+        return static_cast<double>(RUNNING_SUM_WINDOW + 4) * DBL_EPSILON * largestSum;
+    }
+}
+
+long long termsBelowLimit(double a0, double d, long long n, double limit) {
+    if (n <= 0) {
+        return 0;
+    }
+
+    // The first running sum is the first term itself, so this check is exact
+    if (a0 >= limit) {
+        return 0;
+    }
+
+    // reached(k): the first k terms sum to the limit or more (closed form)
+    auto reached = [&](long long k) { return sequenceStats(a0, d, k).sum >= limit; };
+
+    // Smallest real k with S(k) - limit >= 0, from A*k^2 + B*k + C = 0
+    const double A = d / 2.0;
+    const double B = a0 - d / 2.0;
+    const double C = -limit;
+    const double never = static_cast<double>(n) + 1.0;
+    double root = never;
+
+    if (A == 0.0) {
+        if (B > 0.0) {
+            root = -C / B;
+        }
+    }
+    else {
+        const double discriminant = B * B - 4.0 * A * C;
+        if (discriminant >= 0.0) {
+            const double s = sqrt(discriminant);
+            const double r1 = (-B - s) / (2.0 * A);
+            const double r2 = (-B + s) / (2.0 * A);
+            const double lo = min(r1, r2);
+            const double hi = max(r1, r2);
+            if (A > 0.0) {
+                root = hi;                 // S(k) - limit >= 0 beyond the larger root
+            }
+            else if (hi >= 1.0 && ceil(max(lo, 1.0)) <= hi + 1.0) {
+                root = max(lo, 1.0);       // Between the roots; none if no integer fits
+            }
+        }
+    }
+
+    long long k = (root >= never) ? n + 1 : max(2LL, static_cast<long long>(ceil(root)));
+
+    // The closed form and the root are rounded; settle the boundary on exact checks
+    for (int step = 0; step < 4 && k > 2 && k <= n + 1 && reached(k - 1); ++step) {
+        --k;
+    }
+    for (int step = 0; step < 4 && k <= n && !reached(k); ++step) {
+        ++k;
+    }
+
+    const long long count = (k > n || !reached(k)) ? n : k - 1;
+
+    // The closed form is trusted only where no running sum can be within
+    // rounding of the limit; near a tie the terms are added as the loop does.
+    // S(1) = a0 is exact; otherwise the largest S(j), j <= count, is S(count)
+    // or, for d < 0, the one next to the vertex of the parabola.
+    auto clearlyBelow = [&](long long j) {
+        return j <= 1 || sequenceStats(a0, d, j).sum + roundingBound(a0, d, j) < limit;
+    };
+    bool below = clearlyBelow(count);
+    if (d < 0.0) {
+        const double vertex = 0.5 - a0 / d;
+        if (vertex > 1.0 && vertex < static_cast<double>(count)) {
+            const long long peak = static_cast<long long>(vertex);
+            below = below && clearlyBelow(peak) && clearlyBelow(peak + 1);
+        }
+    }
+    const bool reachedNext = count == n
+        || sequenceStats(a0, d, count + 1).sum - roundingBound(a0, d, count + 1) >= limit;
+    if (!below || !reachedNext) {
+        return runningSumCutoff(a0, d, n, limit);
+    }
+    return count;
+}
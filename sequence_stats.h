@@ -0,0 +1,41 @@
+#pragma once
+
+/**
+ * @brief Sum, average and number of terms of an arithmetic sequence.
+ */
+struct SequenceStats {
+    long long count = 0;
+    double sum = 0.0;
+    double average = 0.0;    ///< 0 for an empty sequence
+};
+
+/**
+ * @brief Returns the i-th term (1-based) of the sequence a0, a0 + d, ...
+ */
+inline double sequenceTerm(double a0, double d, long long i) {
+    return a0 + static_cast<double>(i - 1) * d;
+}
+
+/**
+ * @brief Statistics of the first n terms in O(1): sum = n * (first + last) / 2.
+ * @param a0 Initial term
+ * @param d Common difference
+ * @param n Number of terms (values <= 0 give an empty sequence)
+ */
+SequenceStats sequenceStats(double a0, double d, long long n);
+
+/**
+ * @brief Number of leading terms taken before the running sum reaches a limit.
+ * Follows the loop "stop before the term that makes sum >= limit". The cutoff
+ * is found by solving the quadratic S(k) = d/2 * k^2 + (a0 - d/2) * k = limit.
+ * Only when a partial sum is within rounding error of the limit (an exact or
+ * near tie) are the last 64 terms before the cutoff added one by one, as the
+ * loop does, starting from the correctly rounded sum of the earlier terms.
+ * Cutoffs within the first 64 terms therefore fall exactly as in the loop.
+ * @param a0 Initial term
+ * @param d Common difference
+ * @param n Maximum number of terms
+ * @param limit Sum limit
+ * @return Terms taken, between 0 and n
+ */
+long long termsBelowLimit(double a0, double d, long long n, double limit);
@@ -3,63 +3,11 @@
 #include <iomanip>
 #include <stdexcept>
 
-using namespace std;
-
-/**
- * @brief Helper class for dual output to console and file simultaneously.
- * Eliminates code duplication by combining cout and file write operations.
- * Automatically manages file lifecycle through RAII pattern.
- */
-class DualOutputWriter {
-private:
-    ofstream file_;
-
-public:
-    /**
-     * @brief Constructs DualOutputWriter with file path.
-     * @param filepath Path to the output file
-     * @throws runtime_error if file cannot be opened
-     */
-    explicit DualOutputWriter(const string& filepath) {
-        file_.open(filepath);
-        if (!file_.is_open()) {
-            throw runtime_error("Error opening output file: " + filepath);
-        }
-    }
+#include "dual_output_writer.h"
+#include "instrumentation.h"
+#include "tasks.h"
 
-    /**
-     * @brief Destructor ensures file is properly closed (RAII pattern).
-     */
-    ~DualOutputWriter() {
-        if (file_.is_open()) {
-            file_.close();
-        }
-    }
-
-    /**
-     * @brief Outputs data to both console and file simultaneously.
-     * @tparam T Data type to output
-     * @param data Data to write
-     * @return Reference to this object for method chaining
-     */
-    template<typename T>
-    DualOutputWriter& operator<<(const T& data) {
-        cout << data;
-        file_ << data;
-        return *this;
-    }
-
-    /**
-     * @brief Specialization for stream manipulators (endl, setprecision, etc.).
-     * @param manip Stream manipulator function
-     * @return Reference to this object for method chaining
-     */
-    DualOutputWriter& operator<<(ostream& (*manip)(ostream&)) {
-        cout << manip;
-        file_ << manip;
-        return *this;
-    }
-};
+using namespace std;
 
 /**
  * @brief Executes arithmetic operations on two user-provided values.
@@ -68,24 +16,29 @@ public:
  *
  * @note The increment/decrement demonstrations use temporary variables to preserve
  *       original input values for accurate documentation.
+ *
+ * @param outputPath Path to the output file
  */
-void task1() {
+void task1(const string& outputPath) {
     try {
         // Initialize dual output writer with automatic file management
-        DualOutputWriter output("output_task1.txt");
+        DualOutputWriter output(outputPath);
 
         // Retrieve user input with validation
         double a, b;
-        cout << "Enter value A: ";
-        cin >> a;
-        cout << "Enter value B: ";
-        cin >> b;
+        taskConsole() << "Enter value A: ";
+        taskInput() >> a;
+        taskConsole() << "Enter value B: ";
+        taskInput() >> b;
 
         // Validate input stream state
-        if (!cin) {
+        if (!taskInput()) {
             throw runtime_error("Invalid input: Please enter valid numeric values");
         }
 
+        LAB_PHASE(Phase::FORMAT);
+        LAB_COUNT(Counter::RECORDS, 2);
+
         // --- Arithmetic Operations Section ---
         output << "\n--- Arithmetic Operations ---\n";
 
@@ -118,13 +71,13 @@ void task1() {
         output << "B--: " << temp_b-- << " (now: " << temp_b << ")\n";
 
         // Success message
-        output << "\nResults saved to output_task1.txt\n";
+        output << "\nResults saved to " << outputPath << "\n";
 
     }
     catch (const runtime_error& e) {
-        cerr << "Task 1 Error: " << e.what() << endl;
+        taskErrors() << "Task 1 Error: " << e.what() << endl;
     }
     catch (const exception& e) {
-        cerr << "Unexpected error: " << e.what() << endl;
+        taskErrors() << "Unexpected error: " << e.what() << endl;
     }
 }
\ No newline at end of file
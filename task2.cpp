@@ -3,62 +3,66 @@
 #include <stdexcept>
 #include <iomanip>
 #include <limits>
+#include <algorithm>
+#include <array>
+
+#include "dual_output_writer.h"
+#include "instrumentation.h"
+#include "mapped_file.h"
+#include "sequence_generator.h"
+#include "sequence_kernels.h"
+#include "sequence_stats.h"
+#include "task2.h"
+#include "tasks.h"
+#include "text_scanner.h"
 
 using namespace std;
 
 /**
- * @brief Helper class for dual output to console and file simultaneously.
- * Eliminates code duplication by combining cout and file write operations.
- * Automatically manages file lifecycle through RAII pattern.
+ * @brief Writes terms first .. first + count - 1, each followed by a space.
+ * The block is generated by the SIMD kernel and then formatted in bulk.
+ * @param count Number of terms, at most TERM_BLOCK
  */
-class DualOutputWriter {
-private:
-    ofstream file_;
-
-public:
-    /**
-     * @brief Constructs DualOutputWriter with file path.
-     * @param filepath Path to the output file
-     * @throws runtime_error if file cannot be opened
-     */
-    explicit DualOutputWriter(const string& filepath) {
-        file_.open(filepath);
-        if (!file_.is_open()) {
-            throw runtime_error("Cannot open output file: " + filepath);
-        }
-    }
+void writeTermBlock(double a0, double d, long long first, long long count, DualOutputWriter& output) {
+    array<double, TERM_BLOCK> terms;
+    fillSequenceTerms(a0, d, first, static_cast<size_t>(count), terms.data());
+    output.writeGeneral(terms.data(), static_cast<size_t>(count));
+}
 
-    /**
-     * @brief Destructor ensures file is properly closed (RAII pattern).
-     */
-    ~DualOutputWriter() {
-        if (file_.is_open()) {
-            file_.close();
+/**
+ * @brief Appends terms first .. first + count - 1 to out, each followed by a space.
+ * Same bytes as writeTermBlock(), formatted into a caller-owned string.
+ */
+void formatTermRange(double a0, double d, long long first, long long count, string& out) {
+    constexpr size_t FIELD_SIZE = fast_format::MAX_GENERAL_CHARS + 6 + 1;  // Precision 6 and separator
+    array<double, TERM_BLOCK> terms;
+
+    for (long long done = 0; done < count; done += TERM_BLOCK) {
+        const size_t block = static_cast<size_t>(min(TERM_BLOCK, count - done));
+        fillSequenceTerms(a0, d, first + done, block, terms.data());
+
+        const size_t start = out.size();
+        out.resize(start + block * FIELD_SIZE);
+        char* end = out.data() + start;
+        for (size_t k = 0; k < block; ++k) {
+            end = fast_format::formatField(end, generalField(terms[k]));
+            *end++ = ' ';
         }
+        out.resize(static_cast<size_t>(end - out.data()));
     }
+}
 
-    /**
-     * @brief Outputs data to both console and file simultaneously.
-     * @tparam T Data type to output
-     * @param data Data to write
-     * @return Reference to this object for method chaining
-     */
-    template<typename T>
-    DualOutputWriter& operator<<(const T& data) {
-        cout << data;
-        file_ << data;
-        return *this;
-    }
-
-    /**
-     * @brief Specialization for stream manipulators (endl, setprecision, etc.).
-     */
-    DualOutputWriter& operator<<(ostream& (*manip)(ostream&)) {
-        cout << manip;
-        file_ << manip;
-        return *this;
-    }
-};
+/**
+ * @brief Writes terms 1 .. count like the block loops, but on sharedThreadPool().
+ * Each worker formats a chunk of PARALLEL_CHUNK_TERMS terms into its own
+ * buffer and the writer places the chunks at their prefix-sum offsets.
+ */
+void writeTermsParallel(double a0, double d, long long count, DualOutputWriter& output) {
+    output.writeChunks(sharedThreadPool(), count, PARALLEL_CHUNK_TERMS,
+        [a0, d](long long first, long long chunk, string& out) {
+            formatTermRange(a0, d, first + 1, chunk, out);
+        });
+}
 
 /**
  * @brief Reads the initial value (A0) from input file.
@@ -67,16 +71,16 @@ public:
  * @throws runtime_error if file cannot be opened or contains invalid data
  */
 double readInitialValue(const string& filepath) {
-    ifstream inputFile(filepath);
+    LAB_PHASE(Phase::PARSE);
+    MappedInputFile inputFile(filepath);
     if (!inputFile.is_open()) {
         throw runtime_error("Input file '" + filepath + "' not found.\n"
             "Please create the file with the A0 value inside.");
     }
 
     double a0;
-    inputFile >> a0;
-
-    if (!inputFile) {
+    TextScanner scanner(inputFile.view());
+    if (!scanner.next(a0)) {
         throw runtime_error("Invalid data in input file: expected numeric A0 value.");
     }
 
@@ -85,34 +89,32 @@ double readInitialValue(const string& filepath) {
 
 /**
  * @brief Calculates arithmetic sequence statistics.
+ * Count, sum and average come from the closed form (see sequence_stats.h),
+ * so the cost does not depend on n unless the terms are printed.
  * @param a0 Initial term
  * @param d Common difference
  * @param n Number of terms
  * @param output Dual output writer for console and file
  * @param term_limit Optional limit for cumulative sum (0 = no limit)
+ * @param printTerms If false, only the statistics are written
  * @return Number of terms generated
  */
-int generateSequence(double a0, double d, int n, DualOutputWriter& output,
-    double term_limit = 0.0) {
-    int count = 0;
-    double sum = 0.0;
-
-    for (int i = 1; i <= n; ++i) {
-        double term = a0 + (i - 1) * d;
+long long generateSequence(double a0, double d, long long n, DualOutputWriter& output,
+    double term_limit, bool printTerms) {
+    long long count = (term_limit > 0) ? termsBelowLimit(a0, d, n, term_limit) : max(n, 0LL);
+    SequenceStats stats = sequenceStats(a0, d, count);
 
-        // Check sum limit if specified
-        if (term_limit > 0 && sum + term >= term_limit) {
-            break;
+    if (printTerms && count >= PARALLEL_MIN_TERMS) {
+        writeTermsParallel(a0, d, count, output);
+    }
+    else if (printTerms) {
+        for (long long i = 1; i <= count; i += TERM_BLOCK) {
+            writeTermBlock(a0, d, i, min(TERM_BLOCK, count - i + 1), output);
         }
-
-        output << term << " ";
-        sum += term;
-        count++;
     }
 
     // Output statistics
-    double average = (count > 0) ? sum / count : 0.0;
-    output << "\nSum: " << sum << "\nAverage: " << average << "\n";
+    output << "\nSum: " << stats.sum << "\nAverage: " << stats.average << "\n";
 
     return count;
 }
@@ -124,22 +126,29 @@ int generateSequence(double a0, double d, int n, DualOutputWriter& output,
  *
  * Reads initial value (A0) from file, then generates arithmetic sequences
  * with specified number of terms and common difference using different loop structures.
+ *
+ * Sums and averages are computed in O(1) from A0, d and n; the loops only
+ * print the terms, which printTerms = false skips (e.g. for n = 10^12).
+ *
+ * @param inputPath Path to the file holding A0
+ * @param outputPath Path to the output file
+ * @param printTerms If false, only the statistics of each part are written
  */
-void task2() {
+void task2(const string& inputPath, const string& outputPath, bool printTerms) {
     try {
         // Read initial value from input file
-        double a0 = readInitialValue("input_task2.txt");
+        double a0 = readInitialValue(inputPath);
 
         // Get user input with validation
-        int n;
+        long long n;
         double d;
 
-        cout << "Enter n (number of terms): ";
-        cin >> n;
-        cout << "Enter d (common difference): ";
-        cin >> d;
+        taskConsole() << "Enter n (number of terms): ";
+        taskInput() >> n;
+        taskConsole() << "Enter d (common difference): ";
+        taskInput() >> d;
 
-        if (!cin) {
+        if (!taskInput()) {
             throw runtime_error("Invalid input: Please enter valid numeric values");
         }
 
@@ -148,73 +157,76 @@ void task2() {
         }
 
         // Initialize dual output writer
-        DualOutputWriter output("output_task2.txt");
+        DualOutputWriter output(outputPath);
+        LAB_PHASE(Phase::FORMAT);  // Terms are computed as they are formatted
+
+        // Statistics of all n terms and of the terms below the sum limit (part 3)
+        constexpr double SUM_LIMIT = 120.0;
+        const SequenceStats stats = sequenceStats(a0, d, n);
+        const long long limitedCount = termsBelowLimit(a0, d, n, SUM_LIMIT);
+        const SequenceStats limited = sequenceStats(a0, d, limitedCount);
+        const char* skipped = printTerms ? "" : "(not printed)";
 
         // --- PART 1: FOR LOOP ---
-        output << "=== PART 1: FOR LOOP ===\nSequence terms: ";
+        output << "=== PART 1: FOR LOOP ===\nSequence terms: " << skipped;
 
-        double sum = 0.0;
-        for (int i = 1; i <= n; ++i) {
-            double term = a0 + (i - 1) * d;
-            output << term << " ";
-            sum += term;
+        if (printTerms && n >= PARALLEL_MIN_TERMS) {
+            writeTermsParallel(a0, d, n, output);
+        }
+        else if (printTerms) {
+            for (long long i = 1; i <= n; i += TERM_BLOCK) {
+                writeTermBlock(a0, d, i, min(TERM_BLOCK, n - i + 1), output);
+            }
         }
 
-        double average = (n > 0) ? sum / n : 0.0;
-        output << "\nSum: " << sum << "\nAverage: " << average << "\n";
+        output << "\nSum: " << stats.sum << "\nAverage: " << stats.average << "\n";
 
         // --- PART 2: WHILE LOOP ---
-        output << "\n=== PART 2: WHILE LOOP ===\nSequence terms: ";
-
-        sum = 0.0;
-        int i = 1;
-        while (i <= n) {
-            double term = a0 + (i - 1) * d;
-            output << term << " ";
-            sum += term;
-            ++i;
+        output << "\n=== PART 2: WHILE LOOP ===\nSequence terms: " << skipped;
+
+        if (printTerms && n >= PARALLEL_MIN_TERMS) {
+            writeTermsParallel(a0, d, n, output);
+        }
+        else if (printTerms) {
+            long long i = 1;
+            while (i <= n) {
+                writeTermBlock(a0, d, i, min(TERM_BLOCK, n - i + 1), output);
+                i += TERM_BLOCK;
+            }
         }
 
-        int count = i - 1;
-        average = (count > 0) ? sum / count : 0.0;
-        output << "\nSum: " << sum << "\nAverage: " << average << "\n";
+        output << "\nSum: " << stats.sum << "\nAverage: " << stats.average << "\n";
 
         // --- PART 3: DO...WHILE LOOP ---
         output << "\n=== PART 3: DO...WHILE LOOP ===\n";
+        output << "Sequence terms (sum < " << SUM_LIMIT << "): " << skipped;
 
-        constexpr double SUM_LIMIT = 120.0;
-        output << "Sequence terms (sum < " << SUM_LIMIT << "): ";
-
-        sum = 0.0;
-        i = 1;
-        count = 0;
-
-        if (n > 0) {
+        // The cutoff is solved analytically; the loop prints the terms before it
+        if (printTerms && limitedCount >= PARALLEL_MIN_TERMS) {
+            writeTermsParallel(a0, d, limitedCount, output);
+        }
+        else if (printTerms && limitedCount > 0) {
+            // Terms are pulled one at a time; none is computed past the cutoff
+            Generator<double> terms = take(arithmeticSequence(a0, d), limitedCount);
+            auto term = terms.begin();
             do {
-                if (i > n) break;
-
-                double term = a0 + (i - 1) * d;
-
-                // Stop if adding next term exceeds limit
-                if (sum + term >= SUM_LIMIT) break;
-
-                output << term << " ";
-                sum += term;
-                count++;
-                ++i;
-            } while (true);
+                output << generalField(*term) << " ";
+                ++term;
+            } while (term != terms.end());
         }
 
-        average = (count > 0) ? sum / count : 0.0;
-        output << "\nSum: " << sum << "\nAverage: " << average << "\n";
+        output << "\nSum: " << limited.sum << "\nAverage: " << limited.average << "\n";
+        if (printTerms) {
+            LAB_COUNT(Counter::RECORDS, 2 * n + limitedCount);
+        }
 
-        output << "\nResults saved to output_task2.txt\n";
+        output << "\nResults saved to " << outputPath << "\n";
 
     }
     catch (const runtime_error& e) {
-        cerr << "Task 2 Error: " << e.what() << endl;
+        taskErrors() << "Task 2 Error: " << e.what() << endl;
     }
     catch (const exception& e) {
-        cerr << "Unexpected error: " << e.what() << endl;
+        taskErrors() << "Unexpected error: " << e.what() << endl;
     }
 }
\ No newline at end of file
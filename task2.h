@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+#include "dual_output_writer.h"
+
+// Terms generated and formatted per block
+constexpr long long TERM_BLOCK = 1024;
+
+// From this many terms on, a part is formatted and written by sharedThreadPool()
+constexpr long long PARALLEL_MIN_TERMS = 1 << 16;
+
+// Terms per chunk of the parallel writer
+constexpr long long PARALLEL_CHUNK_TERMS = 1 << 16;
+
+// Sequence helpers of task 2 (documented at their definitions in task2.cpp)
+double readInitialValue(const std::string& filepath);
+void writeTermBlock(double a0, double d, long long first, long long count, DualOutputWriter& output);
+void formatTermRange(double a0, double d, long long first, long long count, std::string& out);
+void writeTermsParallel(double a0, double d, long long count, DualOutputWriter& output);
+long long generateSequence(double a0, double d, long long n, DualOutputWriter& output,
+    double term_limit = 0.0, bool printTerms = true);
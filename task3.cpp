@@ -1,129 +1,176 @@
-﻿#include <iostream>
+﻿#include <charconv>
+#include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <string>
-#include <array>
+#include <string_view>
 #include <stdexcept>
-#include <functional>
 
-using namespace std;
-
-// Matrix dimensions as constexpr for compile-time usage
-constexpr int ROWS = 4;
-constexpr int COLS = 3;
+#include "instrumentation.h"
+#include "mapped_file.h"
+#include "matrix_multiply.h"
+#include "matrix_text.h"
+#include "matrix_transpose.h"
+#include "task3.h"
+#include "tasks.h"
 
-/**
- * @brief Helper class for dual output to console and file simultaneously.
- * Eliminates code duplication by combining cout and file write operations.
- * Automatically manages file lifecycle through RAII pattern.
- */
-class DualOutputWriter {
-private:
-    ofstream file_;
+using namespace std;
 
-public:
+namespace {
     /**
-     * @brief Constructs DualOutputWriter with file path.
-     * @param filepath Path to the output file
-     * @throws runtime_error if file cannot be opened
+     * @brief Returns true if the whole token is an integer.
      */
-    explicit DualOutputWriter(const string& filepath) {
-        file_.open(filepath);
-        if (!file_.is_open()) {
-            throw runtime_error("Cannot open output file: " + filepath);
-        }
+    bool parseDimension(string_view token, long long& value) {
+        TextScanner scanner(token);
+        return scanner.next(value) && scanner.atEnd();
     }
 
     /**
-     * @brief Destructor ensures file is properly closed (RAII pattern).
+     * @brief Reads both matrices from text laid out one row per line, rows parsed in parallel.
+     * @return false for any other layout (see parseMatrixRows())
      */
-    ~DualOutputWriter() {
-        if (file_.is_open()) {
-            file_.close();
+    bool readMatrixRows(string_view text, MatrixView a, MatrixView b) {
+        LAB_PHASE(Phase::PARSE);
+        if (!parseMatrixRows(text, { a, b })) {
+            return false;
         }
+        LAB_COUNT(Counter::RECORDS, 2 * a.rows() * a.cols());
+        return true;
     }
 
     /**
-     * @brief Outputs data to both console and file simultaneously.
-     * @tparam T Data type to output
-     * @param data Data to write
-     * @return Reference to this object for method chaining
+     * @brief Reads both input matrices, from a binary matrix file or from text.
+     * @param contents Whole input file
+     * @param a First matrix (output)
+     * @param b Second matrix (output)
      */
-    template<typename T>
-    DualOutputWriter& operator<<(const T& data) {
-        cout << data;
-        file_ << data;
-        return *this;
+    void readInputMatrices(string_view contents, Matrix& a, Matrix& b) {
+        if (BinaryMatrixFile::matches(contents)) {
+            BinaryMatrixFile input(contents);
+            a = Matrix::uninitialized(input.rows(), input.cols());
+            b = Matrix::uninitialized(input.rows(), input.cols());
+            readMatrix(input, 0, a);
+            readMatrix(input, 1, b);
+            return;
+        }
+
+        TextScanner input(contents);
+        size_t rows, cols;
+        readMatrixShape(input, rows, cols);
+        a = Matrix::uninitialized(rows, cols);
+        b = Matrix::uninitialized(rows, cols);
+        if (readMatrixRows(string_view(input.position(), static_cast<size_t>(contents.data() + contents.size()
+            - input.position())), a, b)) {
+            return;
+        }
+
+        // Not one row per line: the sequential reader takes any layout and reports missing data
+        readMatrix(input, a);
+        readMatrix(input, b);
     }
 
     /**
-     * @brief Specialization for stream manipulators (endl, setprecision, etc.).
+     * @brief Appends a matrix as text, one line per row, in the shortest form that reads back exactly.
      */
-    DualOutputWriter& operator<<(ostream& (*manip)(ostream&)) {
-        cout << manip;
-        file_ << manip;
-        return *this;
+    void appendMatrixText(ConstMatrixView matrix, string& text) {
+        char buffer[32];
+        for (size_t i = 0; i < matrix.rows(); ++i) {
+            const double* row = matrix[i];
+            for (size_t j = 0; j < matrix.cols(); ++j) {
+                if (j > 0) {
+                    text += ' ';
+                }
+                text.append(buffer, to_chars(buffer, buffer + sizeof(buffer), row[j]).ptr);
+            }
+            text += '\n';
+        }
     }
-};
+}
 
 /**
- * @brief Type alias for 2D matrix with dimensions ROWS x COLS.
+ * @brief Reads the optional "rows cols" header line of the input.
+ * A first line with anything else is matrix data of the original
+ * DEFAULT_ROWS x DEFAULT_COLS format and is left unread.
+ * @param input Scanner over the mapped input file
+ * @param rows Receives the number of rows of each matrix
+ * @param cols Receives the number of columns of each matrix
+ * @throws runtime_error if the header holds a zero or negative dimension
  */
-using Matrix = array<array<double, COLS>, ROWS>;
+void readMatrixShape(TextScanner& input, size_t& rows, size_t& cols) {
+    rows = DEFAULT_ROWS;
+    cols = DEFAULT_COLS;
+
+    TextScanner probe = input;
+    string_view line;
+    while (probe.nextLine(line) && line.find_first_not_of(" \t\r") == string_view::npos) {
+    }
+
+    TextScanner header(line);
+    string_view first, second, extra;
+    long long headerRows, headerCols;
+    if (!header.next(first) || !header.next(second) || header.next(extra)
+        || !parseDimension(first, headerRows) || !parseDimension(second, headerCols)) {
+        return;
+    }
+    if (headerRows <= 0 || headerCols <= 0) {
+        throw runtime_error("Invalid matrix dimensions in header: '" + string(line) + "'");
+    }
+
+    rows = static_cast<size_t>(headerRows);
+    cols = static_cast<size_t>(headerCols);
+    input = probe;
+}
 
 /**
  * @brief Reads a matrix from an input file.
- * @param input Input stream to read from
- * @param matrix Reference to matrix to populate
+ * @param input Scanner over the mapped input file
+ * @param matrix Matrix to populate, already sized
  * @throws runtime_error if read operation fails
  */
-void readMatrix(ifstream& input, Matrix& matrix) {
-    for (int i = 0; i < ROWS; ++i) {
-        for (int j = 0; j < COLS; ++j) {
-            input >> matrix[i][j];
-            if (!input) {
+void readMatrix(TextScanner& input, MatrixView matrix) {
+    LAB_PHASE(Phase::PARSE);
+    for (size_t i = 0; i < matrix.rows(); ++i) {
+        double* row = matrix[i];
+        for (size_t j = 0; j < matrix.cols(); ++j) {
+            if (!input.next(row[j])) {
                 throw runtime_error("Error reading matrix data from file");
             }
         }
     }
+    LAB_COUNT(Counter::RECORDS, matrix.rows() * matrix.cols());
 }
 
 /**
- * @brief Displays a matrix with formatted output.
- * Outputs matrix to both console and file with proper spacing and precision.
- * @param matrix Matrix to display
- * @param output DualOutputWriter for simultaneous console and file output
+ * @brief Reads a matrix from a binary matrix file, with no parsing.
+ * INT32 files are converted to double.
+ * @param input Validated binary matrix file
+ * @param index Position of the matrix in the file
+ * @param matrix Matrix to populate, already sized as the file's matrices
+ * @throws runtime_error if the file holds fewer matrices or another shape
  */
-void displayMatrix(const Matrix& matrix, DualOutputWriter& output) {
-    for (int i = 0; i < ROWS; ++i) {
-        for (int j = 0; j < COLS; ++j) {
-            output << setw(8) << fixed << setprecision(2) << matrix[i][j];
-        }
-        output << "\n";
+void readMatrix(const BinaryMatrixFile& input, size_t index, MatrixView matrix) {
+    LAB_PHASE(Phase::PARSE);
+    if (index >= input.count()) {
+        throw runtime_error("Error reading matrix data from file");
     }
+    input.read(index, matrix);
+    LAB_COUNT(Counter::RECORDS, matrix.rows() * matrix.cols());
 }
 
 /**
- * @brief Applies a binary operation to two matrices element-wise.
- * Stores the result in a third matrix.
- * @param a First operand matrix
- * @param b Second operand matrix
- * @param result Output matrix for results
- * @param op Binary operation function (e.g., std::plus, std::minus)
- * @param op_name Name of operation for error messages
+ * @brief Displays a matrix with formatted output.
+ * Outputs matrix to both console and file with proper spacing and precision.
+ * @param matrix Matrix to display
+ * @param output DualOutputWriter for simultaneous console and file output
  */
-void applyElementWiseOperation(const Matrix& a, const Matrix& b, Matrix& result,
-    function<double(double, double)> op,
-    const string& op_name) {
-    try {
-        for (int i = 0; i < ROWS; ++i) {
-            for (int j = 0; j < COLS; ++j) {
-                result[i][j] = op(a[i][j], b[i][j]);
-            }
+void displayMatrix(ConstMatrixView matrix, DualOutputWriter& output) {
+    LAB_PHASE(Phase::FORMAT);
+    for (size_t i = 0; i < matrix.rows(); ++i) {
+        const double* row = matrix[i];
+        for (size_t j = 0; j < matrix.cols(); ++j) {
+            output << fixedField(row[j], 8, 2);
         }
-    }
-    catch (const exception& e) {
-        throw runtime_error("Error during " + op_name + " operation: " + e.what());
+        output << "\n";
     }
 }
 
@@ -132,56 +179,72 @@ void applyElementWiseOperation(const Matrix& a, const Matrix& b, Matrix& result,
  * @param a First matrix
  * @param b Second matrix
  * @param result Output matrix containing maximum of corresponding elements
+ * @throws invalid_argument if the three matrices differ in shape
  */
-void maxElementWise(const Matrix& a, const Matrix& b, Matrix& result) {
-    for (int i = 0; i < ROWS; ++i) {
-        for (int j = 0; j < COLS; ++j) {
-            result[i][j] = (a[i][j] > b[i][j]) ? a[i][j] : b[i][j];
-        }
-    }
+void maxElementWise(ConstMatrixView a, ConstMatrixView b, MatrixView result) {
+    LAB_PHASE(Phase::COMPUTE);
+    transformElements(a, b, result, MaxOp());
 }
 
 /**
- * @brief Transposes a matrix from ROWS×COLS to COLS×ROWS.
- * Note: Returns a different size type; only works when source is 4×3 (result: 3×4).
+ * @brief Transposes a rows×cols matrix into a cols×rows one.
+ * Tiled, with SIMD micro-kernels and a parallel path (see transposeInto()).
  * @param matrix Source matrix
- * @param transposed Output transposed matrix
+ * @param transposed Output matrix of cols×rows
+ * @throws invalid_argument if transposed does not have the transposed shape
  */
-void transposeMatrix(const Matrix& matrix, array<array<double, ROWS>, COLS>& transposed) {
-    for (int i = 0; i < ROWS; ++i) {
-        for (int j = 0; j < COLS; ++j) {
-            transposed[j][i] = matrix[i][j];
-        }
-    }
+void transposeMatrix(ConstMatrixView matrix, MatrixView transposed) {
+    LAB_PHASE(Phase::COMPUTE);
+    transposeInto(matrix, transposed);
+}
+
+/**
+ * @brief Matrix product a × transpose(b) of two rows×cols matrices.
+ * Blocked and vectorized (see multiplyTransposedInto()); b is never transposed in memory.
+ * @param a Left matrix, rows×cols
+ * @param b Right matrix, rows×cols
+ * @param product Output matrix of rows×rows
+ * @throws invalid_argument if the shapes do not match
+ */
+void multiplyByTransposed(ConstMatrixView a, ConstMatrixView b, MatrixView product) {
+    LAB_PHASE(Phase::COMPUTE);
+    multiplyTransposedInto(a, b, product);
 }
 
 /**
  * @brief Executes matrix arithmetic operations.
  * Demonstrates element-wise operations (addition, subtraction, multiplication, division),
- * element-wise maximum, and matrix transposition.
+ * element-wise maximum, matrix transposition and, on request, the matrix product A × Bᵀ.
  * All results are logged to both console and file.
  *
- * Reads two 4×3 matrices from input file and performs:
+ * Reads two matrices of the size given in the input header (4×3 without one)
+ * and performs:
  * - Arithmetic operations: +, -, *, /
  * - Element-wise maximum comparison
- * - Matrix transposition (4×3 → 3×4)
+ * - Matrix transposition (rows×cols → cols×rows)
+ * - With printProduct, the product of the first matrix and the transposed
+ *   second (rows×rows), skipped above PRODUCT_MAX_ROWS rows
+ *
+ * @param inputPath Path to the file holding both matrices
+ * @param outputPath Path to the output file
+ * @param printProduct If true, also writes A × Bᵀ
  */
-void task3() {
+void task3(const string& inputPath, const string& outputPath, bool printProduct) {
     try {
         // Open and validate input file
-        ifstream input("input_task3.txt");
-        if (!input.is_open()) {
-            throw runtime_error("Input file 'input_task3.txt' not found");
+        MappedInputFile inputFile(inputPath);
+        if (!inputFile.is_open()) {
+            throw runtime_error("Input file '" + inputPath + "' not found");
         }
 
         // Read matrices from input file
         Matrix a, b;
-        readMatrix(input, a);
-        readMatrix(input, b);
-        input.close();
+        readInputMatrices(inputFile.view(), a, b);
+        const size_t rows = a.rows();
+        const size_t cols = a.cols();
 
         // Initialize output writer
-        DualOutputWriter output("output_task3.txt");
+        DualOutputWriter output(outputPath);
 
         // --- Display Input Matrices ---
         output << "--- Array 1 ---\n";
@@ -191,32 +254,27 @@ void task3() {
         displayMatrix(b, output);
 
         // --- Perform Element-Wise Arithmetic Operations ---
-        Matrix result;
+        // Results are overwritten whole, so their pages are first touched by the computing threads
+        Matrix result = Matrix::uninitialized(rows, cols);
 
         // Addition
         output << "\n--- Sum (+) ---\n";
-        applyElementWiseOperation(a, b, result,
-            [](double x, double y) { return x + y; }, "addition");
+        applyElementWiseOperation(a, b, result, AddOp(), "addition");
         displayMatrix(result, output);
 
         // Subtraction
         output << "\n--- Diff (-) ---\n";
-        applyElementWiseOperation(a, b, result,
-            [](double x, double y) { return x - y; }, "subtraction");
+        applyElementWiseOperation(a, b, result, SubtractOp(), "subtraction");
         displayMatrix(result, output);
 
         // Multiplication
         output << "\n--- Mult (*) ---\n";
-        applyElementWiseOperation(a, b, result,
-            [](double x, double y) { return x * y; }, "multiplication");
+        applyElementWiseOperation(a, b, result, MultiplyOp(), "multiplication");
         displayMatrix(result, output);
 
         // Division with zero-check
         output << "\n--- Div (/) ---\n";
-        applyElementWiseOperation(a, b, result,
-            [](double x, double y) {
-                return (y != 0.0) ? x / y : 0.0;
-            }, "division");
+        applyElementWiseOperation(a, b, result, SafeDivideOp(), "division");
         displayMatrix(result, output);
 
         // --- Element-Wise Maximum ---
@@ -224,24 +282,69 @@ void task3() {
         maxElementWise(a, b, result);
         displayMatrix(result, output);
 
-        // --- Transposed Max Array (3x4) ---
-        output << "\n--- Transposed Max Array (3x4) ---\n";
-        array<array<double, ROWS>, COLS> transposed;
+        // --- Transposed Max Array (cols x rows) ---
+        output << "\n--- Transposed Max Array (" << cols << "x" << rows << ") ---\n";
+        Matrix transposed = Matrix::uninitialized(cols, rows);
         transposeMatrix(result, transposed);
-        for (int j = 0; j < COLS; ++j) {
-            for (int i = 0; i < ROWS; ++i) {
-                output << setw(8) << fixed << setprecision(2) << transposed[j][i];
-            }
-            output << "\n";
+        displayMatrix(transposed, output);
+
+        // --- Matrix Product A x B^T (rows x rows), on request ---
+        if (printProduct && rows > PRODUCT_MAX_ROWS) {
+            output << "\n--- Product A x B^T skipped: " << rows << " rows, at most "
+                << PRODUCT_MAX_ROWS << " are written ---\n";
+        }
+        else if (printProduct) {
+            output << "\n--- Product A x B^T (" << rows << "x" << rows << ") ---\n";
+            Matrix product(rows, rows);
+            multiplyByTransposed(a, b, product);
+            displayMatrix(product, output);
         }
 
-        output << "\nTask 3 completed. Results saved to 'output_task3.txt'\n";
+        output << "\nTask 3 completed. Results saved to '" << outputPath << "'\n";
 
     }
     catch (const runtime_error& e) {
-        cerr << "Task 3 Error: " << e.what() << endl;
+        taskErrors() << "Task 3 Error: " << e.what() << endl;
     }
     catch (const exception& e) {
-        cerr << "Unexpected error: " << e.what() << endl;
+        taskErrors() << "Unexpected error: " << e.what() << endl;
+    }
+}
+
+/**
+ * @brief Converts a task 3 input between text and a FLOAT64 binary matrix file.
+ * A text input (with or without the "rows cols" header) becomes a binary file
+ * of both matrices; a binary input becomes text with the header and a blank
+ * line between the matrices, every value written so that it reads back exactly.
+ * @param inputPath Input file in either format
+ * @param outputPath File to write in the other format
+ * @throws runtime_error if a file cannot be read or written
+ */
+void convertTask3Input(const string& inputPath, const string& outputPath) {
+    MappedInputFile inputFile(inputPath);
+    if (!inputFile.is_open()) {
+        throw runtime_error("Input file '" + inputPath + "' not found");
     }
-}
\ No newline at end of file
+
+    if (!BinaryMatrixFile::matches(inputFile.view())) {
+        Matrix a, b;
+        readInputMatrices(inputFile.view(), a, b);
+        writeBinaryMatrixFile(outputPath, MatrixDataType::FLOAT64, 2, a.rows(), a.cols(),
+            [&](size_t m, size_t i) -> const void* { return (m == 0 ? a : b)[i]; });
+        return;
+    }
+
+    BinaryMatrixFile input(inputFile.view());
+    Matrix matrix(input.rows(), input.cols());
+    string text = to_string(input.rows()) + " " + to_string(input.cols()) + "\n";
+    for (size_t m = 0; m < input.count(); ++m) {
+        input.read(m, matrix);
+        text += '\n';
+        appendMatrixText(matrix, text);
+    }
+
+    ofstream output(outputPath, ios::binary | ios::trunc);
+    if (!output.is_open() || !output.write(text.data(), static_cast<streamsize>(text.size()))) {
+        throw runtime_error("Cannot write output file: " + outputPath);
+    }
+}
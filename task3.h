@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+#include "dual_output_writer.h"
+#include "dynamic_matrix.h"
+#include "elementwise.h"
+#include "instrumentation.h"
+#include "matrix_file.h"
+#include "text_scanner.h"
+
+// Matrix dimensions of inputs without a "rows cols" header (the original fixed format)
+constexpr std::size_t DEFAULT_ROWS = 4;
+constexpr std::size_t DEFAULT_COLS = 3;
+
+// Most rows for which task 3 writes the product A x B^T (rows x rows values) when asked to
+constexpr std::size_t PRODUCT_MAX_ROWS = 1024;
+
+/**
+ * @brief Matrix type of task 3, sized from the input header.
+ */
+using Matrix = DynamicMatrix;
+
+// Matrix kernels of task 3 (documented at their definitions in task3.cpp)
+void readMatrixShape(TextScanner& input, std::size_t& rows, std::size_t& cols);
+void readMatrix(TextScanner& input, MatrixView matrix);
+void readMatrix(const BinaryMatrixFile& input, std::size_t index, MatrixView matrix);
+void displayMatrix(ConstMatrixView matrix, DualOutputWriter& output);
+void maxElementWise(ConstMatrixView a, ConstMatrixView b, MatrixView result);
+void transposeMatrix(ConstMatrixView matrix, MatrixView transposed);
+void multiplyByTransposed(ConstMatrixView a, ConstMatrixView b, MatrixView product);
+
+/**
+ * @brief Applies a binary operation to two matrices element-wise.
+ * Stores the result in a third matrix. The operation is inlined through
+ * transformElements(); AddOp, SubtractOp, MultiplyOp, SafeDivideOp and MaxOp
+ * run the pre-instantiated vectorized kernels.
+ * @param a First operand matrix
+ * @param b Second operand matrix
+ * @param result Output matrix for results
+ * @param op Binary operation, any callable double(double, double)
+ * @param op_name Name of operation for error messages
+ * @throws runtime_error naming the operation if the shapes differ or op throws
+ */
+template<typename Op>
+void applyElementWiseOperation(ConstMatrixView a, ConstMatrixView b, MatrixView result,
+    Op op, const std::string& op_name) {
+    LAB_PHASE(Phase::COMPUTE);
+    try {
+        transformElements(a, b, result, op);
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error during " + op_name + " operation: " + e.what());
+    }
+}
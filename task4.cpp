@@ -5,83 +5,13 @@
 #include <algorithm>
 #include <stdexcept>
 
-using namespace std;
-
-/**
- * @brief Helper class for dual output to console and file simultaneously.
- * Eliminates code duplication by combining cout and file write operations.
- * Automatically manages file lifecycle through RAII pattern.
- */
-class DualOutputWriter {
-private:
-    ofstream file_;
-
-public:
-    /**
-     * @brief Constructs DualOutputWriter with file path.
-     * @param filepath Path to the output file
-     * @throws runtime_error if file cannot be opened
-     */
-    explicit DualOutputWriter(const string& filepath) {
-        file_.open(filepath);
-        if (!file_.is_open()) {
-            throw runtime_error("Cannot open output file: " + filepath);
-        }
-    }
+#include "instrumentation.h"
+#include "mapped_file.h"
+#include "task4.h"
+#include "tasks.h"
+#include "text_scanner.h"
 
-    /**
-     * @brief Destructor ensures file is properly closed (RAII pattern).
-     */
-    ~DualOutputWriter() {
-        if (file_.is_open()) {
-            file_.close();
-        }
-    }
-
-    /**
-     * @brief Outputs data to both console and file simultaneously.
-     * @tparam T Data type to output
-     * @param data Data to write
-     * @return Reference to this object for method chaining
-     */
-    template<typename T>
-    DualOutputWriter& operator<<(const T& data) {
-        cout << data;
-        file_ << data;
-        return *this;
-    }
-
-    /**
-     * @brief Specialization for stream manipulators (endl, setprecision, etc.).
-     */
-    DualOutputWriter& operator<<(ostream& (*manip)(ostream&)) {
-        cout << manip;
-        file_ << manip;
-        return *this;
-    }
-};
-
-/**
- * @brief Type alias for integer vector for cleaner code.
- */
-using IntVector = vector<int>;
-
-/**
- * @brief Prints an array/vector with a descriptive label to output stream.
- * Formats output with proper spacing and field width for readability.
- *
- * @param arr Container with integer elements
- * @param label Descriptive label for the output
- * @param output Reference to output stream (or DualOutputWriter)
- */
-template<typename Container>
-void printArray(const Container& arr, const string& label, DualOutputWriter& output) {
-    output << label << ": ";
-    for (const auto& val : arr) {
-        output << setw(4) << val << " ";
-    }
-    output << "\n";
-}
+using namespace std;
 
 /**
  * @brief Reads integers from an input file into a vector.
@@ -92,58 +22,27 @@ void printArray(const Container& arr, const string& label, DualOutputWriter& out
  * @throws runtime_error if file cannot be opened or is empty
  */
 IntVector readFromFile(const string& filepath) {
-    ifstream input(filepath);
-    if (!input.is_open()) {
+    LAB_PHASE(Phase::PARSE);
+    MappedInputFile inputFile(filepath);
+    if (!inputFile.is_open()) {
         throw runtime_error("Input file '" + filepath + "' not found");
     }
 
     IntVector data;
+    TextScanner input(inputFile.view());
     int value;
-    while (input >> value) {
+    while (input.next(value)) {
         data.push_back(value);
     }
 
     if (data.empty()) {
         throw runtime_error("Input file is empty");
     }
+    LAB_COUNT(Counter::RECORDS, data.size());
 
-    input.close();
     return data;
 }
 
-/**
- * @brief Searches for all occurrences of a key in a container.
- * Performs linear search to find all matching indices.
- *
- * @param arr Container to search
- * @param key Value to search for
- * @param output DualOutputWriter for result output
- * @return Number of occurrences found
- */
-template<typename Container>
-int searchAndPrint(const Container& arr, int key, DualOutputWriter& output) {
-    vector<int> positions;
-
-    for (int i = 0; i < static_cast<int>(arr.size()); ++i) {
-        if (arr[i] == key) {
-            positions.push_back(i);
-        }
-    }
-
-    output << "Found at: ";
-    if (!positions.empty()) {
-        for (int pos : positions) {
-            output << pos << " ";
-        }
-    }
-    else {
-        output << "Not found";
-    }
-    output << "\n";
-
-    return positions.size();
-}
-
 /**
  * @brief Executes array sorting and searching operations.
  * Demonstrates selection sort implementation and linear search functionality.
@@ -157,19 +56,22 @@ int searchAndPrint(const Container& arr, int key, DualOutputWriter& output) {
  *
  * @note Uses std::vector for automatic memory management instead of manual new/delete.
  * @note Uses std::sort from STL for production code; selection sort shown for educational purposes.
+ *
+ * @param inputPath Path to the file holding the integers
+ * @param outputPath Path to the output file
  */
-void task4() {
+void task4(const string& inputPath, const string& outputPath) {
     try {
         // Read data from input file
-        IntVector fileData = readFromFile("input_task4.txt");
+        IntVector fileData = readFromFile(inputPath);
         int count = fileData.size();
 
         // Prompt user for array size
         int n;
-        cout << "File has " << count << " numbers. Enter n to use: ";
-        cin >> n;
+        taskConsole() << "File has " << count << " numbers. Enter n to use: ";
+        taskInput() >> n;
 
-        if (!cin) {
+        if (!taskInput()) {
             throw runtime_error("Invalid input: please enter a valid integer");
         }
 
@@ -185,7 +87,7 @@ void task4() {
         IntVector sorted = original;  // Copy for sorting
 
         // Initialize dual output writer
-        DualOutputWriter output("output_task4.txt");
+        DualOutputWriter output(outputPath);
 
         // --- Display Original Array ---
         output << "========== ARRAY OPERATIONS ==========\n";
@@ -195,16 +97,20 @@ void task4() {
         // Using std::sort for production code (more efficient than selection sort)
         // Selection sort kept as comment for educational demonstration:
         // selectionSort(sorted, n);
-        std::sort(sorted.begin(), sorted.end());
+        {
+            LAB_PHASE(Phase::COMPUTE);
+            std::sort(sorted.begin(), sorted.end());
+        }
 
         printArray(sorted, "Sorted", output);
 
         // --- Search for User-Specified Key ---
+        output.flush();  // Show arrays before prompting
         int key;
-        cout << "Search key: ";
-        cin >> key;
+        taskConsole() << "Search key: ";
+        taskInput() >> key;
 
-        if (!cin) {
+        if (!taskInput()) {
             throw runtime_error("Invalid input: please enter a valid integer");
         }
 
@@ -218,10 +124,10 @@ void task4() {
 
     }
     catch (const runtime_error& e) {
-        cerr << "Task 4 Error: " << e.what() << endl;
+        taskErrors() << "Task 4 Error: " << e.what() << endl;
     }
     catch (const exception& e) {
-        cerr << "Unexpected error: " << e.what() << endl;
+        taskErrors() << "Unexpected error: " << e.what() << endl;
     }
 }
 
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "dual_output_writer.h"
+#include "instrumentation.h"
+
+/**
+ * @brief Type alias for integer vector for cleaner code.
+ */
+using IntVector = std::vector<int>;
+
+/**
+ * @brief Prints an array/vector with a descriptive label to output stream.
+ * Formats output with proper spacing and field width for readability.
+ *
+ * @param arr Container with integer elements
+ * @param label Descriptive label for the output
+ * @param output Reference to output stream (or DualOutputWriter)
+ */
+template<typename Container>
+void printArray(const Container& arr, const std::string& label, DualOutputWriter& output) {
+    LAB_PHASE(Phase::FORMAT);
+    output << label << ": ";
+    for (const auto& val : arr) {
+        output << intField(val, 4) << " ";
+    }
+    output << "\n";
+}
+
+// Array helpers of task 4 (documented at their definitions in task4.cpp)
+IntVector readFromFile(const std::string& filepath);
+void selectionSort(int arr[], int n);
+
+/**
+ * @brief Searches for all occurrences of a key in a container.
+ * Performs linear search to find all matching indices.
+ *
+ * @param arr Container to search
+ * @param key Value to search for
+ * @param output DualOutputWriter for result output
+ * @return Number of occurrences found
+ */
+template<typename Container>
+int searchAndPrint(const Container& arr, int key, DualOutputWriter& output) {
+    std::vector<int> positions;
+    {
+        LAB_PHASE(Phase::COMPUTE);
+        for (int i = 0; i < static_cast<int>(arr.size()); ++i) {
+            if (arr[i] == key) {
+                positions.push_back(i);
+            }
+        }
+    }
+
+    LAB_PHASE(Phase::FORMAT);
+    output << "Found at: ";
+    if (!positions.empty()) {
+        for (int pos : positions) {
+            output << pos << " ";
+        }
+    }
+    else {
+        output << "Not found";
+    }
+    output << "\n";
+
+    return positions.size();
+}
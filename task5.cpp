@@ -4,136 +4,44 @@
 #include <algorithm>
 #include <vector>
 #include <array>
+#include <cstring>
 #include <map>
 #include <stdexcept>
 #include <functional>
+#include <string_view>
 
-using namespace std;
-
-/**
- * @brief Helper class for dual output to console and file simultaneously.
- * Eliminates code duplication by combining cout and file write operations.
- * Automatically manages file lifecycle through RAII pattern.
- */
-class DualOutputWriter {
-private:
-    ofstream file_;
-
-public:
-    /**
-     * @brief Constructs DualOutputWriter with file path.
-     * @param filepath Path to the output file
-     * @throws runtime_error if file cannot be opened
-     */
-    explicit DualOutputWriter(const string& filepath) {
-        file_.open(filepath);
-        if (!file_.is_open()) {
-            throw runtime_error("Cannot open output file: " + filepath);
-        }
-    }
+#include "instrumentation.h"
+#include "mapped_file.h"
+#include "matrix_file.h"
+#include "pairwise_sum.h"
+#include "task5.h"
+#include "tasks.h"
+#include "text_scanner.h"
 
-    /**
-     * @brief Destructor ensures file is properly closed (RAII pattern).
-     */
-    ~DualOutputWriter() {
-        if (file_.is_open()) {
-            file_.close();
-        }
-    }
-
-    /**
-     * @brief Outputs data to both console and file simultaneously.
-     * @tparam T Data type to output
-     * @param data Data to write
-     * @return Reference to this object for method chaining
-     */
-    template<typename T>
-    DualOutputWriter& operator<<(const T& data) {
-        cout << data;
-        file_ << data;
-        return *this;
-    }
-
-    /**
-     * @brief Specialization for stream manipulators (endl, setprecision, etc.).
-     */
-    DualOutputWriter& operator<<(ostream& (*manip)(ostream&)) {
-        cout << manip;
-        file_ << manip;
-        return *this;
-    }
-};
+using namespace std;
 
 // ============================================================================
 // FIBONACCI COMPUTATION SECTION
 // ============================================================================
 
-/**
- * @brief Computes Fibonacci number using memoization with global cache.
- * Caches results to avoid redundant calculations.
- * Time complexity: O(n), Space complexity: O(n)
- *
- * @param n Fibonacci index (0-based)
- * @return n-th Fibonacci number
- * @throws invalid_argument if n is negative
- */
-class FibonacciCalculator {
-private:
-    map<int, long long> memo_;  // Thread-safe memoization cache
-    static constexpr int MAX_N = 100;
-
-public:
-    /**
-     * @brief Computes Fibonacci number with memoization.
-     * @param n Index of Fibonacci number
-     * @return n-th Fibonacci number
-     */
-    long long compute(int n) {
-        if (n < 0) {
-            throw invalid_argument("Fibonacci index cannot be negative");
-        }
-        if (n <= 1) {
-            return n;
-        }
-        if (n > MAX_N) {
-            throw invalid_argument("Fibonacci index too large (max: 100)");
-        }
-
-        // Check if already computed
-        if (memo_.find(n) != memo_.end()) {
-            return memo_[n];
-        }
-
-        // Compute and cache
-        memo_[n] = compute(n - 1) + compute(n - 2);
-        return memo_[n];
-    }
-
-    /**
-     * @brief Clears memoization cache.
-     */
-    void clearCache() {
-        memo_.clear();
-    }
-};
-
 /**
  * @brief Executes Fibonacci number generation and summation task.
  * Computes and displays Fibonacci sequence from F(0) to F(n).
  * Outputs results to both console and file.
  *
+ * @param outputPath Path to the output file
  * @throws runtime_error if output file cannot be opened
  * @throws invalid_argument if user input is invalid
  */
-void fibonacciTask() {
+void fibonacciTask(const string& outputPath) {
     try {
         int n;
-        cout << "\n=== FIBONACCI ===\nEnter n (0-100): ";
-        cin >> n;
+        taskConsole() << "\n=== FIBONACCI ===\nEnter n (0-100): ";
+        taskInput() >> n;
 
-        if (!cin) {
-            cin.clear();
-            cin.ignore(10000, '\n');
+        if (!taskInput()) {
+            taskInput().clear();
+            taskInput().ignore(10000, '\n');
             throw invalid_argument("Invalid input: please enter a valid integer");
         }
 
@@ -143,31 +51,38 @@ void fibonacciTask() {
 
         // Initialize calculator and output writer
         FibonacciCalculator fib;
-        DualOutputWriter output("output_fibonacci.txt");
-
-        output << "=== FIBONACCI SEQUENCE (F(0) to F(" << n << ")) ===\n";
+        DualOutputWriter output(outputPath);
 
+        // Compute all terms first so computing and formatting are timed apart
+        vector<long long> terms;
         long long sum = 0;
+        {
+            LAB_PHASE(Phase::COMPUTE);
+            terms = fib.sequence(n);
+            sum = wrappingSum(terms.data(), terms.size());
+        }
+        LAB_COUNT(Counter::RECORDS, terms.size());
+
+        LAB_PHASE(Phase::FORMAT);
+        output << "=== FIBONACCI SEQUENCE (F(0) to F(" << n << ")) ===\n";
         for (int i = 0; i <= n; ++i) {
-            long long value = fib.compute(i);
-            sum += value;
-            output << "F(" << i << ") = " << value << "\n";
+            output << "F(" << intField(i) << ") = " << intField(terms[i]) << "\n";
         }
 
         output << "\n=== STATISTICS ===\n";
         output << "Total terms: " << (n + 1) << "\n";
         output << "Sum of sequence: " << sum << "\n";
-        output << "Last term F(" << n << "): " << fib.compute(n) << "\n";
+        output << "Last term F(" << n << "): " << terms[n] << "\n";
 
     }
     catch (const invalid_argument& e) {
-        cerr << "Input Error: " << e.what() << endl;
+        taskErrors() << "Input Error: " << e.what() << endl;
     }
     catch (const runtime_error& e) {
-        cerr << "File Error: " << e.what() << endl;
+        taskErrors() << "File Error: " << e.what() << endl;
     }
     catch (const exception& e) {
-        cerr << "Unexpected error: " << e.what() << endl;
+        taskErrors() << "Unexpected error: " << e.what() << endl;
     }
 }
 
@@ -175,13 +90,6 @@ void fibonacciTask() {
 // MATRIX OPERATIONS SECTION
 // ============================================================================
 
-/**
- * @brief Type aliases for matrix dimensions and data.
- */
-constexpr int MATRIX_ROWS = 2;
-constexpr int MATRIX_COLS = 5;
-using Matrix = array<array<int, MATRIX_COLS>, MATRIX_ROWS>;
-
 /**
  * @brief Displays a 2D matrix with a descriptive label.
  * Formats output with proper spacing for readability.
@@ -191,10 +99,11 @@ using Matrix = array<array<int, MATRIX_COLS>, MATRIX_ROWS>;
  * @param output DualOutputWriter for simultaneous console and file output
  */
 void displayMatrix(const Matrix& matrix, const string& label, DualOutputWriter& output) {
+    LAB_PHASE(Phase::FORMAT);
     output << "\n" << label << "\n";
     for (int i = 0; i < MATRIX_ROWS; ++i) {
         for (int j = 0; j < MATRIX_COLS; ++j) {
-            output << setw(5) << matrix[i][j] << " ";
+            output << intField(matrix[i][j], 5) << " ";
         }
         output << "\n";
     }
@@ -211,6 +120,7 @@ void displayMatrix(const Matrix& matrix, const string& label, DualOutputWriter&
  * @throws invalid_argument if operation character is invalid
  */
 void applyMatrixOperation(const Matrix& a, const Matrix& b, Matrix& result, char op) {
+    LAB_PHASE(Phase::COMPUTE);
     for (int i = 0; i < MATRIX_ROWS; ++i) {
         for (int j = 0; j < MATRIX_COLS; ++j) {
             switch (op) {
@@ -243,11 +153,13 @@ void applyMatrixOperation(const Matrix& a, const Matrix& b, Matrix& result, char
 void findMinMaxInMatrix(const Matrix& matrix, int choice, DualOutputWriter& output) {
     int minValue = INT_MAX;
     int maxValue = INT_MIN;
-
-    for (int i = 0; i < MATRIX_ROWS; ++i) {
-        for (int j = 0; j < MATRIX_COLS; ++j) {
-            minValue = min(minValue, matrix[i][j]);
-            maxValue = max(maxValue, matrix[i][j]);
+    {
+        LAB_PHASE(Phase::COMPUTE);
+        for (int i = 0; i < MATRIX_ROWS; ++i) {
+            for (int j = 0; j < MATRIX_COLS; ++j) {
+                minValue = min(minValue, matrix[i][j]);
+                maxValue = max(maxValue, matrix[i][j]);
+            }
         }
     }
 
@@ -255,11 +167,35 @@ void findMinMaxInMatrix(const Matrix& matrix, int choice, DualOutputWriter& outp
     int result = (choice % 2 == 1) ? maxValue : minValue;
     string operation = (choice % 2 == 1) ? "Maximum" : "Minimum";
 
+    LAB_PHASE(Phase::FORMAT);
     output << "\n" << operation << " value: " << result << "\n";
 }
 
+namespace {
+    /**
+     * @brief Copies the two matrices of an INT32 binary matrix file, with no parsing.
+     * @throws runtime_error if the file does not hold two 2×5 int matrices
+     */
+    void readBinaryMatrices(string_view contents, Matrix& a, Matrix& b) {
+        BinaryMatrixFile input(contents);
+        if (input.dataType() != MatrixDataType::INT32 || input.rows() != MATRIX_ROWS
+            || input.cols() != MATRIX_COLS) {
+            throw runtime_error("Binary input file must hold 2x5 int32 matrices");
+        }
+        if (input.count() < 2) {
+            throw runtime_error(input.count() == 0 ? "Insufficient data in input file for matrix A"
+                : "Insufficient data in input file for matrix B");
+        }
+        for (int i = 0; i < MATRIX_ROWS; ++i) {
+            memcpy(a[i].data(), input.row(0, i), sizeof(a[i]));
+            memcpy(b[i].data(), input.row(1, i), sizeof(b[i]));
+        }
+    }
+}
+
 /**
  * @brief Reads two 2×5 matrices from input file.
+ * The file is whitespace-separated text or an INT32 binary matrix file (matrix_file.h).
  *
  * @param filepath Path to input file
  * @param a First matrix (output)
@@ -267,14 +203,21 @@ void findMinMaxInMatrix(const Matrix& matrix, int choice, DualOutputWriter& outp
  * @throws runtime_error if file cannot be opened or contains insufficient data
  */
 void readMatricesFromFile(const string& filepath, Matrix& a, Matrix& b) {
-    ifstream input(filepath);
-    if (!input.is_open()) {
+    LAB_PHASE(Phase::PARSE);
+    MappedInputFile inputFile(filepath);
+    if (!inputFile.is_open()) {
         throw runtime_error("Input file '" + filepath + "' not found");
     }
+    if (BinaryMatrixFile::matches(inputFile.view())) {
+        readBinaryMatrices(inputFile.view(), a, b);
+        LAB_COUNT(Counter::RECORDS, 2 * MATRIX_ROWS * MATRIX_COLS);
+        return;
+    }
 
+    TextScanner input(inputFile.view());
     for (int i = 0; i < MATRIX_ROWS; ++i) {
         for (int j = 0; j < MATRIX_COLS; ++j) {
-            if (!(input >> a[i][j])) {
+            if (!input.next(a[i][j])) {
                 throw runtime_error("Insufficient data in input file for matrix A");
             }
         }
@@ -282,11 +225,55 @@ void readMatricesFromFile(const string& filepath, Matrix& a, Matrix& b) {
 
     for (int i = 0; i < MATRIX_ROWS; ++i) {
         for (int j = 0; j < MATRIX_COLS; ++j) {
-            if (!(input >> b[i][j])) {
+            if (!input.next(b[i][j])) {
                 throw runtime_error("Insufficient data in input file for matrix B");
             }
         }
     }
+    LAB_COUNT(Counter::RECORDS, 2 * MATRIX_ROWS * MATRIX_COLS);
+}
+
+/**
+ * @brief Converts a task 5 input between text and an INT32 binary matrix file.
+ * Text becomes a binary file of both 2×5 matrices; a binary file becomes text
+ * in the layout of input_arrays.txt.
+ * @param inputPath Input file in either format
+ * @param outputPath File to write in the other format
+ * @throws runtime_error if a file cannot be read or written, or holds too few values
+ */
+void convertTask5Input(const string& inputPath, const string& outputPath) {
+    Matrix a, b;
+    readMatricesFromFile(inputPath, a, b);
+
+    bool binaryInput;
+    {
+        MappedInputFile inputFile(inputPath);
+        binaryInput = BinaryMatrixFile::matches(inputFile.view());
+    }
+    if (!binaryInput) {
+        writeBinaryMatrixFile(outputPath, MatrixDataType::INT32, 2, MATRIX_ROWS, MATRIX_COLS,
+            [&](size_t m, size_t i) -> const void* { return (m == 0 ? a : b)[i].data(); });
+        return;
+    }
+
+    ofstream output(outputPath, ios::trunc);
+    if (!output.is_open()) {
+        throw runtime_error("Cannot write output file: " + outputPath);
+    }
+    for (const Matrix* matrix : { &a, &b }) {
+        if (matrix == &b) {
+            output << "\n";
+        }
+        for (const auto& row : *matrix) {
+            for (int j = 0; j < MATRIX_COLS; ++j) {
+                output << (j > 0 ? " " : "") << row[j];
+            }
+            output << "\n";
+        }
+    }
+    if (!output) {
+        throw runtime_error("Cannot write output file: " + outputPath);
+    }
 }
 
 /**
@@ -294,17 +281,19 @@ void readMatricesFromFile(const string& filepath, Matrix& a, Matrix& b) {
  * Allows user to perform arithmetic operations on two matrices and find min/max values.
  * Supports up to 3 operations per execution.
  *
+ * @param inputPath Path to the file holding both matrices
+ * @param outputPath Path to the output file
  * @throws runtime_error if input file cannot be opened
  * @throws invalid_argument if user input is invalid
  */
-void matrixTask() {
+void matrixTask(const string& inputPath, const string& outputPath) {
     try {
         // Read matrices from file
         Matrix a, b, result;
-        readMatricesFromFile("input_arrays.txt", a, b);
+        readMatricesFromFile(inputPath, a, b);
 
         // Initialize output writer
-        DualOutputWriter output("output_matrix_operations.txt");
+        DualOutputWriter output(outputPath);
 
         output << "========== MATRIX OPERATIONS ==========\n";
         displayMatrix(a, "Array 1:", output);
@@ -313,13 +302,14 @@ void matrixTask() {
         // Perform up to 3 operations
         constexpr int MAX_OPERATIONS = 3;
         for (int iteration = 0; iteration < MAX_OPERATIONS; ++iteration) {
-            cout << "\nOperation " << (iteration + 1) << "/3 (+, -, *, /, m for min/max): ";
+            output.flush();  // Show previous results before prompting
+            taskConsole() << "\nOperation " << (iteration + 1) << "/3 (+, -, *, /, m for min/max): ";
             char op;
-            cin >> op;
+            taskInput() >> op;
 
-            if (!cin) {
-                cin.clear();
-                cin.ignore(10000, '\n');
+            if (!taskInput()) {
+                taskInput().clear();
+                taskInput().ignore(10000, '\n');
                 throw invalid_argument("Invalid input: please enter a valid operation");
             }
 
@@ -328,11 +318,12 @@ void matrixTask() {
 
             if (op == 'm' || op == 'M') {
                 // Min/Max operation
-                cout << "Select (1:max A, 2:min A, 3:max B, 4:min B): ";
+                output.flush();  // Show the operation header before prompting
+                taskConsole() << "Select (1:max A, 2:min A, 3:max B, 4:min B): ";
                 int choice;
-                cin >> choice;
+                taskInput() >> choice;
 
-                if (!cin || choice < 1 || choice > 4) {
+                if (!taskInput() || choice < 1 || choice > 4) {
                     throw invalid_argument("Invalid choice: must be 1-4");
                 }
 
@@ -351,13 +342,13 @@ void matrixTask() {
 
     }
     catch (const runtime_error& e) {
-        cerr << "File Error: " << e.what() << endl;
+        taskErrors() << "File Error: " << e.what() << endl;
     }
     catch (const invalid_argument& e) {
-        cerr << "Input Error: " << e.what() << endl;
+        taskErrors() << "Input Error: " << e.what() << endl;
     }
     catch (const exception& e) {
-        cerr << "Unexpected error: " << e.what() << endl;
+        taskErrors() << "Unexpected error: " << e.what() << endl;
     }
 }
 
@@ -368,13 +359,17 @@ void matrixTask() {
 /**
  * @brief Main task dispatcher for task5.
  * Executes both Fibonacci and matrix operation subtasks sequentially.
+ *
+ * @param inputPath Path to the file holding both matrices
+ * @param outputPath Path to the matrix operations output file
+ * @param fibonacciOutputPath Path to the Fibonacci output file
  */
-void task5() {
+void task5(const string& inputPath, const string& outputPath, const string& fibonacciOutputPath) {
     try {
-        fibonacciTask();
-        matrixTask();
+        fibonacciTask(fibonacciOutputPath);
+        matrixTask(inputPath, outputPath);
     }
     catch (const exception& e) {
-        cerr << "Task 5 Error: " << e.what() << endl;
+        taskErrors() << "Task 5 Error: " << e.what() << endl;
     }
 }
\ No newline at end of file
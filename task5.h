@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "dual_output_writer.h"
+#include "linear_recurrence.h"
+
+/**
+ * @brief Computes Fibonacci numbers with the FIBONACCI linear recurrence.
+ * A single term takes O(log n) steps and needs no cache; terms past F(92)
+ * wrap around like unsigned 64-bit arithmetic.
+ */
+class FibonacciCalculator {
+private:
+    static constexpr int MAX_N = 100;
+
+    static void checkIndex(int n) {
+        if (n < 0) {
+            throw std::invalid_argument("Fibonacci index cannot be negative");
+        }
+        if (n > MAX_N) {
+            throw std::invalid_argument("Fibonacci index too large (max: 100)");
+        }
+    }
+
+public:
+    /**
+     * @brief Computes one Fibonacci number.
+     * @param n Index of Fibonacci number
+     * @return n-th Fibonacci number
+     * @throws invalid_argument if n is negative or above 100
+     */
+    long long compute(int n) const {
+        checkIndex(n);
+        return FIBONACCI.term(n);
+    }
+
+    /**
+     * @brief Returns F(0) .. F(n).
+     * @throws invalid_argument if n is negative or above 100
+     */
+    std::vector<long long> sequence(int n) const {
+        checkIndex(n);
+        std::vector<long long> terms(static_cast<std::size_t>(n) + 1);
+        FIBONACCI.fill(0, terms.size(), terms.data());
+        return terms;
+    }
+};
+
+/**
+ * @brief Type aliases for matrix dimensions and data.
+ */
+constexpr int MATRIX_ROWS = 2;
+constexpr int MATRIX_COLS = 5;
+using Matrix = std::array<std::array<int, MATRIX_COLS>, MATRIX_ROWS>;
+
+// Matrix helpers of task 5 (documented at their definitions in task5.cpp)
+void displayMatrix(const Matrix& matrix, const std::string& label, DualOutputWriter& output);
+void applyMatrixOperation(const Matrix& a, const Matrix& b, Matrix& result, char op);
+void findMinMaxInMatrix(const Matrix& matrix, int choice, DualOutputWriter& output);
+void readMatricesFromFile(const std::string& filepath, Matrix& a, Matrix& b);
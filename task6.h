@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "dual_output_writer.h"
+#include "instrumentation.h"
+#include "mapped_file.h"
+#include "tasks.h"
+#include "text_scanner.h"
+
+/**
+ * @brief Represents a student record with academic information.
+ * Contains all necessary fields for student database management.
+ */
+struct Student {
+    int id;              ///< Unique student identifier
+    std::string surname;      ///< Student's last name
+    int birthYear;       ///< Year of birth
+    int studyYear;       ///< Current study year (1-4)
+    double gpa;          ///< Grade Point Average
+
+    /**
+     * @brief Validates student record for consistency.
+     * @return true if all fields are valid, false otherwise
+     */
+    bool isValid() const {
+        return id > 0 && !surname.empty() && birthYear >= 1950 && birthYear <= 2015 &&
+            studyYear >= 1 && studyYear <= 4 && gpa >= 0.0 && gpa <= 5.0;
+    }
+};
+
+/**
+ * @brief Student database management system.
+ * Handles loading, saving, searching, and displaying student records.
+ */
+class StudentDatabase {
+private:
+    std::vector<Student> students_;
+    std::string dbFile_;
+    std::string outputFile_;
+
+public:
+    /**
+     * @brief Constructs database and loads existing records from file.
+     * If no file exists, initializes with default sample data.
+     * @param dbFile Path to the database file
+     * @param outputFile Path to the file search results are appended to
+     */
+    explicit StudentDatabase(const std::string& dbFile = TASK6_DATABASE,
+        const std::string& outputFile = TASK6_OUTPUT)
+        : dbFile_(dbFile), outputFile_(outputFile) {
+        loadFromFile();
+        if (students_.empty()) {
+            initializeSampleData();
+        }
+    }
+
+    /**
+     * @brief Loads student records from database file.
+     * @throws runtime_error if file read operation fails
+     */
+    void loadFromFile() {
+        LAB_PHASE(Phase::PARSE);
+        MappedInputFile inputFile(dbFile_);
+        if (!inputFile.is_open()) {
+            taskErrors() << "Warning: Database file '" << dbFile_ << "' not found. Starting fresh.\n";
+            return;
+        }
+
+        TextScanner input(inputFile.view());
+        std::string_view line;
+        while (input.nextLine(line)) {
+            if (line.empty()) continue;
+
+            TextScanner fields(line);
+            Student student;
+            std::string_view surname;
+            if (fields.next(student.id) && fields.next(surname) && fields.next(student.birthYear)
+                && fields.next(student.studyYear) && fields.next(student.gpa)) {
+                student.surname.assign(surname);
+                if (student.isValid()) {
+                    students_.push_back(student);
+                }
+                else {
+                    taskErrors() << "Warning: Skipping invalid record (ID: " << student.id << ")\n";
+                }
+            }
+        }
+        LAB_COUNT(Counter::RECORDS, students_.size());
+    }
+
+    /**
+     * @brief Initializes database with sample student records.
+     * Used when no existing database file is found.
+     */
+    void initializeSampleData() {
+        students_ = {
+            {101, "Ivanov", 2005, 1, 4.5},
+            {102, "Petrov", 2004, 2, 3.8},
+            {103, "Sidorov", 2006, 1, 4.2},
+            {104, "Sokolov", 2003, 3, 3.9},
+            {105, "Kozlov", 2004, 2, 4.1}
+        };
+    }
+
+    /**
+     * @brief Saves all student records to database file.
+     * Overwrites existing file with current database state.
+     * @throws runtime_error if file write operation fails
+     */
+    void saveToFile() {
+        LAB_PHASE(Phase::WRITE);
+        std::ofstream output(dbFile_);
+        if (!output.is_open()) {
+            throw std::runtime_error("Cannot open database file for writing: " + dbFile_);
+        }
+
+        for (const auto& student : students_) {
+            output << student.id << " " << student.surname << " "
+                << student.birthYear << " " << student.studyYear << " "
+                << std::fixed << std::setprecision(1) << student.gpa << "\n";
+        }
+        LAB_COUNT(Counter::BYTES_OUT, output.tellp());
+        output.close();
+    }
+
+    /**
+     * @brief Adds a new student record to the database.
+     * Validates data before insertion and saves to file.
+     * @param student Student record to add
+     * @throws invalid_argument if student record is invalid
+     * @throws runtime_error if file save operation fails
+     */
+    void addStudent(const Student& student) {
+        if (!student.isValid()) {
+            throw std::invalid_argument("Invalid student record: check ID, year ranges, and GPA bounds");
+        }
+
+        // Check for duplicate ID
+        if (findById(student.id) != nullptr) {
+            throw std::invalid_argument("Student with ID " + std::to_string(student.id) + " already exists");
+        }
+
+        students_.push_back(student);
+        saveToFile();
+        taskConsole() << "Student record added successfully.\n";
+    }
+
+    /**
+     * @brief Searches for a student by ID.
+     * @param id Student ID to search for
+     * @return Pointer to student if found, nullptr otherwise
+     */
+    const Student* findById(int id) const {
+        auto it = std::find_if(students_.begin(), students_.end(),
+            [id](const Student& s) { return s.id == id; });
+        return (it != students_.end()) ? &(*it) : nullptr;
+    }
+
+    /**
+     * @brief Searches database using a custom predicate function.
+     * Displays results in formatted table with optional file output.
+     * @param predicate Search condition function
+     * @param title Display title for results
+     */
+    void search(std::function<bool(const Student&)> predicate, const std::string& title) {
+        std::vector<Student> results;
+        {
+            LAB_PHASE(Phase::COMPUTE);
+            std::copy_if(students_.begin(), students_.end(), std::back_inserter(results), predicate);
+        }
+
+        if (results.empty()) {
+            taskConsole() << "No records found matching criteria.\n";
+            return;
+        }
+
+        displayTable(results, title);
+    }
+
+    /**
+     * @brief Displays all student records in formatted table.
+     */
+    void displayAll() {
+        if (students_.empty()) {
+            taskConsole() << "Database is empty.\n";
+            return;
+        }
+        displayTable(students_, "ALL STUDENTS");
+    }
+
+    /**
+     * @brief Returns the total number of students in database.
+     * @return Number of student records
+     */
+    size_t getSize() const {
+        return students_.size();
+    }
+
+private:
+    /**
+     * @brief Displays a collection of student records in formatted table.
+     * Outputs to both console and file.
+     * @param records Collection of students to display
+     * @param title Table title
+     */
+    void displayTable(const std::vector<Student>& records, const std::string& title) {
+        try {
+            DualOutputWriter output(outputFile_, true);  // Append mode
+            LAB_PHASE(Phase::FORMAT);
+            LAB_COUNT(Counter::RECORDS, records.size());
+
+            output << "\n" << std::string(60, '=') << "\n";
+            output << "=== " << title << " ===\n";
+            output << std::string(60, '=') << "\n";
+            output << std::setw(6) << "ID" << " | "
+                << std::setw(15) << "Surname" << " | "
+                << std::setw(11) << "Birth Year" << " | "
+                << std::setw(5) << "Year" << " | "
+                << std::setw(6) << "GPA\n";
+            output << std::string(60, '-') << "\n";
+
+            for (const auto& student : records) {
+                output << std::setw(6) << student.id << " | "
+                    << std::setw(15) << student.surname << " | "
+                    << std::setw(11) << student.birthYear << " | "
+                    << std::setw(5) << student.studyYear << " | "
+                    << std::fixed << std::setprecision(2) << student.gpa << "\n";
+            }
+
+            output << std::string(60, '=') << "\n";
+            output << "Total records: " << records.size() << "\n";
+
+        }
+        catch (const std::runtime_error& e) {
+            taskErrors() << "Error writing to output file: " << e.what() << "\n";
+        }
+    }
+};
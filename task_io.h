@@ -0,0 +1,55 @@
+#pragma once
+
+#include <iostream>
+
+/**
+ * @brief Console streams of the tasks, redirectable per thread.
+ * Tasks read prompt answers from taskInput() and print prompts and errors to
+ * taskConsole() / taskErrors() instead of std::cin, std::cout and std::cerr.
+ * By default these are the standard streams; the batch executor gives every
+ * job its own streams with a TaskIoScope so concurrent jobs do not share them.
+ */
+namespace task_io {
+    inline thread_local std::istream* input = nullptr;
+    inline thread_local std::ostream* console = nullptr;
+    inline thread_local std::ostream* errors = nullptr;
+}
+
+inline std::istream& taskInput() {
+    return task_io::input ? *task_io::input : std::cin;
+}
+
+inline std::ostream& taskConsole() {
+    return task_io::console ? *task_io::console : std::cout;
+}
+
+inline std::ostream& taskErrors() {
+    return task_io::errors ? *task_io::errors : std::cerr;
+}
+
+/**
+ * @brief Redirects the task streams of the calling thread for its lifetime (RAII pattern).
+ */
+class TaskIoScope {
+public:
+    TaskIoScope(std::istream& input, std::ostream& console, std::ostream& errors)
+        : input_(task_io::input), console_(task_io::console), errors_(task_io::errors) {
+        task_io::input = &input;
+        task_io::console = &console;
+        task_io::errors = &errors;
+    }
+
+    ~TaskIoScope() {
+        task_io::input = input_;
+        task_io::console = console_;
+        task_io::errors = errors_;
+    }
+
+    TaskIoScope(const TaskIoScope&) = delete;
+    TaskIoScope& operator=(const TaskIoScope&) = delete;
+
+private:
+    std::istream* input_;
+    std::ostream* console_;
+    std::ostream* errors_;
+};
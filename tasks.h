@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+
+#include "task_io.h"
+
+// Default data files of the six lab tasks (shipped with the repository).
+// main() replaces them with paths given on the command line.
+constexpr const char* TASK1_OUTPUT = "output_task1.txt";
+constexpr const char* TASK2_INPUT = "input_task2.txt";
+constexpr const char* TASK2_OUTPUT = "output_task2.txt";
+constexpr const char* TASK3_INPUT = "input_task3.txt";
+constexpr const char* TASK3_OUTPUT = "output_task3.txt";
+constexpr const char* TASK4_INPUT = "input_task4.txt";
+constexpr const char* TASK4_OUTPUT = "output_task4.txt";
+constexpr const char* TASK5_INPUT = "input_arrays.txt";
+constexpr const char* TASK5_OUTPUT = "output_matrix_operations.txt";
+constexpr const char* TASK5_FIBONACCI_OUTPUT = "output_fibonacci.txt";
+constexpr const char* TASK6_DATABASE = "students_database.txt";
+constexpr const char* TASK6_OUTPUT = "output_students.txt";
+
+// Entry points of the six lab tasks
+void task1(const std::string& outputPath = TASK1_OUTPUT);
+
+void task2(const std::string& inputPath = TASK2_INPUT,
+    const std::string& outputPath = TASK2_OUTPUT,
+    bool printTerms = true);
+
+void task3(const std::string& inputPath = TASK3_INPUT,
+    const std::string& outputPath = TASK3_OUTPUT,
+    bool printProduct = false);
+
+void task4(const std::string& inputPath = TASK4_INPUT,
+    const std::string& outputPath = TASK4_OUTPUT);
+
+void task5(const std::string& inputPath = TASK5_INPUT,
+    const std::string& outputPath = TASK5_OUTPUT,
+    const std::string& fibonacciOutputPath = TASK5_FIBONACCI_OUTPUT);
+
+void task6(const std::string& databasePath = TASK6_DATABASE,
+    const std::string& outputPath = TASK6_OUTPUT);
+
+// Converters of the task 3 and task 5 inputs between text and binary matrix
+// files (matrix_file.h); the direction follows the format of the input
+void convertTask3Input(const std::string& inputPath, const std::string& outputPath);
+void convertTask5Input(const std::string& inputPath, const std::string& outputPath);
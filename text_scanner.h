@@ -0,0 +1,123 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+
+/**
+ * @brief Whitespace-separated token reader over an in-memory character range.
+ * Mirrors `ifstream >> value` for ints and doubles, but parses with
+ * std::from_chars straight from the bytes (usually a MappedInputFile) without
+ * creating strings or streams. A failed read leaves the position unchanged.
+ */
+class TextScanner {
+private:
+    const char* pos_;
+    const char* end_;
+
+    static bool isSpace(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    void skipSpace() {
+        while (pos_ != end_ && isSpace(*pos_)) {
+            ++pos_;
+        }
+    }
+
+    template<typename T>
+    bool nextNumber(T& value) {
+        skipSpace();
+        const char* start = pos_;
+        // from_chars rejects the leading '+' that operator>> accepts
+        if (start != end_ && *start == '+' && start + 1 != end_ && start[1] != '-' && start[1] != '+') {
+            ++start;
+        }
+
+        auto result = std::from_chars(start, end_, value);
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        pos_ = result.ptr;
+        return true;
+    }
+
+public:
+    TextScanner(const char* begin, const char* end) : pos_(begin), end_(end) {}
+
+    explicit TextScanner(std::string_view text) : TextScanner(text.data(), text.data() + text.size()) {}
+
+    /**
+     * @brief Reads the next integer.
+     * @return false on end of input, malformed number or overflow
+     */
+    bool next(int& value) {
+        return nextNumber(value);
+    }
+
+    bool next(long long& value) {
+        return nextNumber(value);
+    }
+
+    /**
+     * @brief Reads the next floating-point number.
+     * @return false on end of input or malformed number
+     */
+    bool next(double& value) {
+        return nextNumber(value);
+    }
+
+    /**
+     * @brief Reads the next whitespace-delimited word.
+     * @param word View into the scanned bytes (valid while they are)
+     * @return false on end of input
+     */
+    bool next(std::string_view& word) {
+        skipSpace();
+        if (pos_ == end_) {
+            return false;
+        }
+        const char* start = pos_;
+        while (pos_ != end_ && !isSpace(*pos_)) {
+            ++pos_;
+        }
+        word = std::string_view(start, static_cast<std::size_t>(pos_ - start));
+        return true;
+    }
+
+    /**
+     * @brief Reads the rest of the current line, like getline().
+     * @param line View of the line without the trailing '\n'
+     * @return false on end of input
+     */
+    bool nextLine(std::string_view& line) {
+        if (pos_ == end_) {
+            return false;
+        }
+        const char* start = pos_;
+        while (pos_ != end_ && *pos_ != '\n') {
+            ++pos_;
+        }
+        line = std::string_view(start, static_cast<std::size_t>(pos_ - start));
+        if (pos_ != end_) {
+            ++pos_;  // Consume '\n'
+        }
+        return true;
+    }
+
+    /**
+     * @brief Returns true if only whitespace is left.
+     */
+    bool atEnd() {
+        skipSpace();
+        return pos_ == end_;
+    }
+
+    /**
+     * @brief Returns the current read position.
+     */
+    const char* position() const {
+        return pos_;
+    }
+};
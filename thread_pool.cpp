@@ -0,0 +1,158 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+using namespace std;
+
+namespace {
+    // Identity of the calling thread if it is a pool worker
+    thread_local ThreadPool* t_pool = nullptr;
+    thread_local size_t t_index = 0;
+}
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+
+    queues_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        queues_.push_back(make_unique<WorkQueue>());
+    }
+
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Puts a task on the caller's own deque (workers) or the next one round-robin.
+ */
+void ThreadPool::push(function<void()> task) {
+    const size_t index = (t_pool == this)
+        ? t_index
+        : nextQueue_.fetch_add(1, memory_order_relaxed) % queues_.size();
+
+    // Count first so queued_ never drops below the number of tasks in the deques
+    {
+        lock_guard<mutex> lock(sleepMutex_);
+        ++queued_;
+    }
+    {
+        lock_guard<mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(move(task));
+    }
+    wake_.notify_one();
+}
+
+/**
+ * @brief Takes the newest task of the own deque, or steals the oldest one of another.
+ * @return false if every deque is empty
+ */
+bool ThreadPool::take(size_t self, function<void()>& task) {
+    bool found = false;
+    {
+        WorkQueue& own = *queues_[self];
+        lock_guard<mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = move(own.tasks.back());
+            own.tasks.pop_back();
+            found = true;
+        }
+    }
+
+    for (size_t i = 1; !found && i < queues_.size(); ++i) {
+        WorkQueue& victim = *queues_[(self + i) % queues_.size()];
+        lock_guard<mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+            found = true;
+        }
+    }
+
+    if (found) {
+        lock_guard<mutex> lock(sleepMutex_);
+        --queued_;
+    }
+    return found;
+}
+
+/**
+ * @brief Runs queued tasks on the calling worker until result is ready.
+ * When no task is queued, the one behind result is already running on
+ * another worker, so blocking on it cannot deadlock.
+ */
+void ThreadPool::helpUntilReady(const future<void>& result) {
+    function<void()> task;
+    while (result.wait_for(chrono::seconds(0)) != future_status::ready) {
+        if (!take(t_index, task)) {
+            result.wait();
+            return;
+        }
+        task();
+        task = nullptr;
+    }
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    t_pool = this;
+    t_index = index;
+
+    function<void()> task;
+    while (true) {
+        if (take(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        unique_lock<mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+        if (stopping_ && queued_ == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::waitAll(vector<future<void>>& futures) {
+    exception_ptr error;
+    for (auto& result : futures) {
+        // A worker that only blocked here could leave every worker waiting
+        // for tasks that none of them is free to run
+        if (t_pool != nullptr) {
+            t_pool->helpUntilReady(result);
+        }
+        try {
+            result.get();
+        }
+        catch (...) {
+            if (!error) {
+                error = current_exception();
+            }
+        }
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+}
+
+ThreadPool& sharedThreadPool() {
+    static ThreadPool pool;
+    return pool;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Fixed-size work-stealing thread pool.
+ * Every worker owns a deque: it takes its own work from the back (most
+ * recently pushed, still warm in cache) and, when that is empty, steals from
+ * the front of the other workers' deques. Work submitted from outside the pool
+ * is spread round-robin; work submitted from a worker goes to its own deque.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Starts the workers.
+     * @param threads Number of workers; 0 means one per hardware thread
+     */
+    explicit ThreadPool(std::size_t threads = 0);
+
+    /**
+     * @brief Runs the remaining queued work, then joins the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t size() const {
+        return workers_.size();
+    }
+
+    /**
+     * @brief Queues a callable and returns a future for its result.
+     * Exceptions thrown by the callable are delivered through the future.
+     */
+    template<typename F>
+    auto submit(F&& function) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(function));
+        std::future<Result> result = task->get_future();
+        push([task]() { (*task)(); });
+        return result;
+    }
+
+    /**
+     * @brief Waits for every future, then rethrows the first exception if any.
+     * Unlike calling get() in a loop, never returns while work is still running,
+     * so the tasks may safely reference the caller's locals.
+     * Called on a pool worker, it runs that pool's queued tasks while it waits,
+     * so a task may wait for work it submitted to its own pool.
+     */
+    static void waitAll(std::vector<std::future<void>>& futures);
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<std::size_t> nextQueue_{ 0 };
+
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::size_t queued_ = 0;    ///< Tasks pushed but not yet taken (guarded by sleepMutex_)
+    bool stopping_ = false;
+
+    void push(std::function<void()> task);
+    bool take(std::size_t self, std::function<void()>& task);
+    void helpUntilReady(const std::future<void>& result);
+    void workerLoop(std::size_t index);
+};
+
+/**
+ * @brief Process-wide pool for data-parallel work inside a task (one worker per hardware thread).
+ * Separate from the pool running batch jobs, so a job's chunks do not queue
+ * behind whole jobs.
+ */
+ThreadPool& sharedThreadPool();